@@ -1,12 +1,74 @@
+//POSIX interfaces: pwrite, ftruncate, fileno and mmap
+#define _POSIX_C_SOURCE 200809L
+
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "BattleByCategory.h"
 #include "LinkedList.h"
 #include "MaxHeap.h"
 
+//Upper bound on the worker threads of a fight batch, and the fewest fights worth a thread of their own
+#define FIGHT_MAX_THREADS 16
+#define FIGHT_MIN_CHUNK 64
+
+//Snapshot files start with this tag, and every part of them starts at a multiple of SNAPSHOT_ALIGN bytes
+#define SNAPSHOT_MAGIC "BTLSNAP1"
+#define SNAPSHOT_ALIGN 8
+
+//Journal files start with this tag, and their records are either an insertion or the removal of a category maximum
+#define JOURNAL_MAGIC "BTLJRNL1"
+#define JOURNAL_INSERT 1
+#define JOURNAL_REMOVE_MAX 2
+
+/**
+ * One slot of the fight cache: the result of the last fight of a challenger profile (class, key),
+ * valid while the battle version is still the one it was computed at.
+ */
+typedef struct FightCacheEntry_s {
+    bool valid;
+    int challenger_class;
+    int challenger_key;
+    unsigned long version;
+    FightResult result;
+} FightCacheEntry;
+
+/**
+ * The share of a fight batch handled by one worker: the challengers in [from, to).
+ */
+typedef struct FightChunk_s {
+    Battle b;
+    element* challengers;
+    FightResult* results;
+    int from;
+    int to;
+} FightChunk;
+
+/**
+ * The worker threads of fightBatch, started by the first batch worth more than one thread and kept until the
+ * battle is destroyed. A batch queues its chunks in chunks[next_chunk..num_chunks) and wakes the workers
+ * through 'work'; pending counts the chunks not finished yet, and the last one to finish signals 'done'.
+ */
+typedef struct FightPool_s {
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t done;
+    pthread_t threads[FIGHT_MAX_THREADS];
+    int num_threads;
+    FightChunk chunks[FIGHT_MAX_THREADS];
+    int next_chunk;
+    int num_chunks;
+    int pending;
+    bool shutdown;
+} FightPool;
+
 /**
  * Represents the main Battle system structure.
  * This structure acts as a container for managing
@@ -16,6 +78,7 @@
  */
 struct battle_s {
     int capacity;
+    capacityPolicy policy;
     int numberOfCategories;
     char* categories;
     LinkedList category_l_list;
@@ -25,6 +88,42 @@ struct battle_s {
     equalFunction eqlfunc;
     getCategoryFunction getcatfunc;
     getAttackFunction getatkfunc;
+    //Interned categories: heaps[id] is the heap of the id-th category in the 'categories' string
+    //(the list still owns the heaps). With getidfunc set, elements are routed by id instead of by name.
+    MaxHeap* heaps;
+    int num_ids;
+    getCategoryIdFunction getidfunc;
+    //Name index of the ids: names[id] points into names_buffer, a tokenized copy of the categories string,
+    //and name_index is an open addressing table of name_slots ids (a power of two, -1 for an empty slot).
+    char* names_buffer;
+    char** names;
+    int* name_index;
+    int name_slots;
+    //Fight index (fight_tree==NULL when disabled): for every challenger class k and group g, a tournament tree
+    //over the category ids whose leaves are the categories in group g for class k. Node n of the tree starting at
+    //fight_tree[(k*fight_groups+g)*2*fight_leaves] holds the id with the strongest top below it (-1 for none),
+    //leaves at n=fight_leaves+id. fight_group[k*num_ids+id] is the group of a category.
+    int* fight_tree;
+    int* fight_group;
+    int fight_leaves;
+    int fight_groups;
+    getCategoryIdFunction challengerfunc;
+    //tops[id] is the cached top of a category. version counts the changes of all the tops: a fight result
+    //may depend on any of them, so one battle-wide version is what every cached fight is checked against.
+    element* tops;
+    unsigned long version;
+    //Leaderboard: a tournament tree over the cached tops of all categories, laid out like a fight index tree
+    //(leaves at n=leader_leaves+id), so leader_tree[1] is the id of the strongest element overall.
+    int* leader_tree;
+    int leader_leaves;
+    //Fight cache (fight_cache==NULL when disabled): a direct-mapped table of cache_slots results
+    //keyed by the challenger's class and key.
+    FightCacheEntry* fight_cache;
+    int cache_slots;
+    getCategoryIdFunction cacheclassfunc;
+    getKeyFunction cachekeyfunc;
+    //Worker threads of fightBatch, NULL until a batch first needs them
+    FightPool* fight_pool;
 };
 
 /**
@@ -71,14 +170,12 @@ static status printHeapWrap(element elem) {
 static int equalheap(element e_heap, element e_key){
     if (!e_heap || !e_key){return -1;}
 
-    MaxHeap heap = (MaxHeap)e_heap;
-    char* n_heap = getHeapid(heap);
+    //The name is compared in place, a lookup allocates nothing
+    char* n_heap = getHeapName((MaxHeap)e_heap);
     if (!n_heap){return -1;}
 
     char* key = (char*)e_key;
-    int cmp = strcmp(key,n_heap);
-    free(n_heap);
-    if (cmp==0) {return 0;}
+    if (strcmp(key,n_heap)==0) {return 0;}
     return -1;
 }
 
@@ -114,9 +211,47 @@ static int cmpheap(element elem1,element elem2) {
     return 0;
 }
 
+/**
+ * Auxiliary function for self use only.
+ * Hashes a category name (djb2), used as the key hash of the category index.
+ * @param e_key The category name.
+ * @return The hash of the name.
+ */
+static unsigned long hashCategory(element e_key) {
+    unsigned long h=5381;
+    for (unsigned char* c=(unsigned char*)e_key; *c; c++) {h=h*33+*c;}
+    return h;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Hashes a category heap by its name, so it lands in the same index bucket as its name.
+ * @param e_heap The generic element (MaxHeap) to hash.
+ * @return The hash of the heap's name, or 0 if the name could not be read.
+ */
+static unsigned long hashHeap(element e_heap) {
+    char* n_heap = getHeapName((MaxHeap)e_heap);
+    if (!n_heap) {return 0;}
+    return hashCategory(n_heap);
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Frees the id tables of a battle, for a battle whose creation failed or that is destroyed.
+ * @param b The battle.
+ */
+static void free_id_tables(Battle b) {
+    free(b->heaps);
+    free(b->tops);
+    free(b->leader_tree);
+    free(b->names_buffer);
+    free(b->names);
+    free(b->name_index);
+}
+
 Battle createBattleByCategory(int capacity,int numberOfCategories,char* categories,equalFunction equalElement,copyFunction copyElement,freeFunction freeElement,getCategoryFunction getCategory,getAttackFunction getAttack,printFunction printElement) {
     //input validation
-    if (!categories || !equalElement || !copyElement ||! printElement || !freeElement ||!getCategory ||!getAttack || capacity<0) {
+    if (!categories || !equalElement || !copyElement ||! printElement || !freeElement ||!getCategory ||!getAttack || (capacity<0 && capacity!=UNBOUNDED_CAPACITY)) {
         return NULL;
     }
     //Allocating memory for deepcopy of 'categories' input string.
@@ -125,11 +260,14 @@ Battle createBattleByCategory(int capacity,int numberOfCategories,char* categori
     strcpy(temp_categories,categories);
 
     //Allocating memory for the linked list structure and releasing the allocations that have succeeded so far if the current allocation fails.
-    LinkedList temp_l=createLinkedList(copyHeapWrap,destroyHeapWrap,printHeapWrap,equalheap,cmpheap);
+    //The list is indexed by category name, every category lookup is a hash probe instead of a scan.
+    LinkedList temp_l=createIndexedLinkedList(copyHeapWrap,destroyHeapWrap,printHeapWrap,equalheap,cmpheap,hashCategory,hashHeap);
     if (!temp_l) {
         free(temp_categories);
         return NULL;
     }
+    //All category nodes come from one slab, so walking the categories stays within one block of memory.
+    if (numberOfCategories>0) {setNodePool(temp_l,numberOfCategories);}
 
     //Allocating memory for the Battle structure and releasing the allocations that have succeeded so far if the current allocation fails.
     Battle battle = (Battle)malloc(sizeof(struct battle_s));
@@ -139,33 +277,74 @@ Battle createBattleByCategory(int capacity,int numberOfCategories,char* categori
         return NULL;
     }
 
+    //The id table has a slot for every comma separated name, which bounds the number of categories.
+    int max_ids=1;
+    for (char* c=categories; *c; c++) {
+        if (*c==',') {max_ids++;}
+    }
+    battle->heaps=(MaxHeap*)malloc(sizeof(MaxHeap)*max_ids);
+    battle->tops=(element*)calloc(max_ids,sizeof(element));
+    battle->leader_leaves=1;
+    while (battle->leader_leaves<max_ids) {battle->leader_leaves*=2;}
+    battle->leader_tree=(int*)malloc(sizeof(int)*2*battle->leader_leaves);
+    //The names are tokenized out of a private copy, the caller's string is left as it is
+    battle->names_buffer=(char*)malloc(strlen(categories)+1);
+    battle->names=(char**)malloc(sizeof(char*)*max_ids);
+    battle->name_slots=2;
+    while (battle->name_slots<2*max_ids) {battle->name_slots*=2;}
+    battle->name_index=(int*)malloc(sizeof(int)*battle->name_slots);
+    if (!battle->heaps || !battle->tops || !battle->leader_tree || !battle->names_buffer || !battle->names || !battle->name_index) {
+        destroyLinkedList(temp_l);
+        free(temp_categories);
+        free_id_tables(battle);
+        free(battle);
+        return NULL;
+    }
+    strcpy(battle->names_buffer,categories);
+    for (int i=0; i<battle->name_slots; i++) {battle->name_index[i]=-1;}
+    //Every category starts empty, so no node of the leaderboard has a winner yet
+    for (int n=1; n<battle->leader_leaves; n++) {battle->leader_tree[n]=-1;}
+    for (int id=0; id<battle->leader_leaves; id++) {
+        battle->leader_tree[battle->leader_leaves+id]=id<max_ids ? id : -1;
+    }
+    battle->num_ids=0;
+
     //Construction of the linked list where each link contains a max heap
-    char* token = strtok(categories,",");
+    char* token = strtok(battle->names_buffer,",");
     while (token!=NULL) {
         //Allocating memory for the 'Max_Heap'. The stack name will be the current 'category' according to the string we received as input from the user.
-        MaxHeap temp_h = createHeap(token,capacity,copyElement,freeElement,printElement,equalElement);
+        MaxHeap temp_h = createIndexedHeap(token,capacity,copyElement,freeElement,printElement,equalElement);
         if (!temp_h) {
             destroyLinkedList(temp_l);
             free(temp_categories);
-            destroyBattleByCategory(battle);
+            free_id_tables(battle);
+            free(battle);
             return NULL;
         }
-        //Adding the heap as a link in the linked list and checking that the addition was successful.
-        status st = appendNode(temp_l, temp_h);
+        //Adding the heap as a link in the linked list (the list adopts it, no copy) and checking that the addition was successful.
+        status st = appendNodeOwned(temp_l, temp_h);
         if (st==failure || st==memory_error) {
             destroyLinkedList(temp_l);
             free(temp_categories);
             destroyHeap(temp_h);
-            destroyBattleByCategory(battle);
+            free_id_tables(battle);
+            free(battle);
             return NULL;
         }
-        destroyHeap(temp_h);
+        //Interning the category: its id is its position in the string, found by name through the name index
+        int slot=(int)(hashCategory(token)&(unsigned long)(battle->name_slots-1));
+        while (battle->name_index[slot]!=-1) {slot=(slot+1)&(battle->name_slots-1);}
+        battle->name_index[slot]=battle->num_ids;
+        battle->names[battle->num_ids]=token;
+        battle->heaps[battle->num_ids]=temp_h;
+        battle->num_ids++;
         //Promote the 'category' to the next category in the string.
         token = strtok(NULL,",");
     }
 
     //Placing the appropriate values in the members of the Battle struct
     battle->capacity=capacity;
+    battle->policy=reject_when_full;
     battle->numberOfCategories=numberOfCategories;
     battle->categories=temp_categories;
     battle->category_l_list=temp_l;
@@ -175,13 +354,35 @@ Battle createBattleByCategory(int capacity,int numberOfCategories,char* categori
     battle->eqlfunc=equalElement;
     battle->getcatfunc=getCategory;
     battle->getatkfunc=getAttack;
+    battle->getidfunc=NULL;
+    battle->fight_tree=NULL;
+    battle->fight_group=NULL;
+    battle->challengerfunc=NULL;
+    battle->version=0;
+    battle->fight_cache=NULL;
+    battle->fight_pool=NULL;
+    battle->cache_slots=0;
+    battle->cacheclassfunc=NULL;
+    battle->cachekeyfunc=NULL;
     return battle;
 }
 
+/**
+ * Auxiliary function for self use only.
+ * Stops the worker threads of fightBatch and frees their pool.
+ * @param pool The pool, or NULL if the battle never started one.
+ */
+static void fight_pool_stop(FightPool* pool);
+
 status destroyBattleByCategory(Battle b) {
     if (!b) {return failure;}
 
+    fight_pool_stop(b->fight_pool);
     free(b->categories);
+    free_id_tables(b);
+    free(b->fight_tree);
+    free(b->fight_group);
+    free(b->fight_cache);
 
     if (destroyLinkedList(b->category_l_list)==success){
         free(b);
@@ -191,20 +392,375 @@ status destroyBattleByCategory(Battle b) {
     return failure;
 }
 
+/**
+ * Auxiliary function for self use only.
+ * Picks the category with the stronger head element; on equal heads (or two empty ones) the lower id wins,
+ * as in the category order scan of fight.
+ * @param b The battle.
+ * @param heads The head element of every category (e.g. the cached tops), NULL for an empty one.
+ * @param x A category id, or -1 for none.
+ * @param y A category id greater than x, or -1 for none.
+ * @return The winning id, or -1 if both are -1 or empty.
+ */
+static int head_winner(Battle b, element* heads, int x, int y) {
+    if (x<0 || !heads[x]) {return y>=0 && heads[y] ? y : -1;}
+    if (y<0 || !heads[y]) {return x;}
+    return b->eqlfunc(heads[y],heads[x])==1 ? y : x;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Replays the matches of one leaf, from its parent up to the root of a tournament tree over the categories.
+ * @param b The battle.
+ * @param heads The head element of every category.
+ * @param tree The tree, with its leaves at n=leaves+id.
+ * @param leaves The number of leaves.
+ * @param id The category id whose head changed.
+ */
+static void head_replay(Battle b, element* heads, int* tree, int leaves, int id) {
+    for (int n=(leaves+id)/2; n>=1; n/=2) {
+        tree[n]=head_winner(b,heads,tree[2*n],tree[2*n+1]);
+    }
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Refreshes the cached top of a category and bumps the battle version, which invalidates the cached fights,
+ * and replays the category's matches in the leaderboard. O(log categories).
+ * With the fight index enabled it also replays the category's matches, in the one tree per challenger class
+ * that holds it as a leaf. O(classes * log categories).
+ * @param b The battle.
+ * @param id The category id.
+ */
+static void fight_index_update(Battle b, int id) {
+    b->tops[id]=TopMaxHeap(b->heaps[id]);
+    b->version++;
+    head_replay(b,b->tops,b->leader_tree,b->leader_leaves,id);
+    if (!b->fight_tree) {return;}
+    for (int k=0; k<b->num_ids; k++) {
+        int* tree=b->fight_tree+(size_t)(k*b->fight_groups+b->fight_group[k*b->num_ids+id])*2*b->fight_leaves;
+        head_replay(b,b->tops,tree,b->fight_leaves,id);
+    }
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Brings the cached tops (and the fight index, if the battle has one) up to date after a category heap changed.
+ * Only a new top costs anything, other changes of the heap do not affect fights.
+ * @param b The battle.
+ * @param id The id of the category that changed.
+ */
+static void fight_index_touch(Battle b, int id) {
+    if (TopMaxHeap(b->heaps[id])!=b->tops[id]) {fight_index_update(b,id);}
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Refreshes every cached top after a change of many categories, bumping the battle version,
+ * and rebuilds the leaderboard and every tree of the fight index if the battle has one.
+ * @param b The battle.
+ */
+static void fight_index_rebuild(Battle b) {
+    for (int id=0; id<b->num_ids; id++) {
+        b->tops[id]=TopMaxHeap(b->heaps[id]);
+    }
+    b->version++;
+    for (int id=0; id<b->leader_leaves; id++) {
+        b->leader_tree[b->leader_leaves+id]=id<b->num_ids ? id : -1;
+    }
+    for (int n=b->leader_leaves-1; n>=1; n--) {
+        b->leader_tree[n]=head_winner(b,b->tops,b->leader_tree[2*n],b->leader_tree[2*n+1]);
+    }
+    if (!b->fight_tree) {return;}
+    for (int k=0; k<b->num_ids; k++) {
+        for (int g=0; g<b->fight_groups; g++) {
+            int* tree=b->fight_tree+(size_t)(k*b->fight_groups+g)*2*b->fight_leaves;
+            for (int id=0; id<b->fight_leaves; id++) {
+                bool in_group=id<b->num_ids && b->fight_group[k*b->num_ids+id]==g;
+                tree[b->fight_leaves+id]=in_group ? id : -1;
+            }
+            for (int n=b->fight_leaves-1; n>=1; n--) {
+                tree[n]=head_winner(b,b->tops,tree[2*n],tree[2*n+1]);
+            }
+        }
+    }
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Adopts an element into its category heap according to the battle's capacity policy.
+ * Under evict_weakest a full heap drops (and frees) its weakest element, but only for a stronger newcomer.
+ * @param b The battle.
+ * @param id The category id of the element.
+ * @param elem The element to adopt, on any error the caller still owns it.
+ * @return success if adopted, failure_fullcapacity if there is no room for it, or another error status.
+ */
+static status insert_with_policy(Battle b, int id, element elem) {
+    MaxHeap heap=b->heaps[id];
+    if (b->policy==evict_weakest && b->capacity!=UNBOUNDED_CAPACITY && getHeapCurrentSize(heap)>=b->capacity) {
+        element weakest=TopMinHeap(heap);
+        if (!weakest || b->eqlfunc(elem,weakest)!=1) {return failure_fullcapacity;}
+        //The eviction is recorded before the element is freed, a newcomer reusing its address is still a new top
+        element evicted=PopMinHeap(heap);
+        fight_index_touch(b,id);
+        b->freefunc(evicted);
+    }
+    status st=insertToHeapOwned(heap,elem);
+    fight_index_touch(b,id);
+    return st;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Category visitor that turns a category heap into a min-max heap.
+ * @param e_heap The generic element (MaxHeap) of the category.
+ * @param ctx A pointer to a status, set to the conversion's error if it fails.
+ * @return true to continue with the next category, false once a conversion failed.
+ */
+static bool convertVisit(element e_heap, element ctx) {
+    status st=convertToMinMaxHeap((MaxHeap)e_heap);
+    if (st==success) {return true;}
+    *(status*)ctx=st;
+    return false;
+}
+
+status setCapacityPolicy(Battle b, capacityPolicy policy) {
+    //input validation
+    if (!b || (policy!=reject_when_full && policy!=evict_weakest)) {return failure;}
+
+    //Evicting needs the weakest element of every category, so the heaps become min-max heaps (a one-way, O(n) change)
+    if (policy==evict_weakest) {
+        status st=success;
+        forEachInList(b->category_l_list,convertVisit,&st);
+        fight_index_rebuild(b);
+        if (st!=success) {return st;}
+    }
+    b->policy=policy;
+    return success;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Finds the category id of an element: from the battle's id function if it has one, otherwise by its name.
+ * @param b The battle.
+ * @param elem The element.
+ * @return The id of the element's category, or -1 if the category is unknown.
+ */
+static int category_id(Battle b, element elem) {
+    //Interned path, no lookup at all
+    if (b->getidfunc) {
+        int id=b->getidfunc(elem);
+        return id>=0 && id<b->num_ids ? id : -1;
+    }
+
+    //Checking the element's category and resolving its name through the name index
+    char* temp_category=b->getcatfunc(elem);
+    if (!temp_category) {return -1;}
+    return getCategoryId(b,temp_category);
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Inserts a copy of an element into a category heap according to the battle's capacity policy.
+ * @param b The battle.
+ * @param id The category id of the element.
+ * @param elem The element to copy, it stays owned by the caller.
+ * @return success if inserted, failure_fullcapacity if there is no room for it, or another error status.
+ */
+static status insert_copy(Battle b, int id, element elem) {
+    //Inserting into the heap and returning the status whether the insertion was successful or not
+    if (b->policy==reject_when_full) {
+        status st=insertToHeap(b->heaps[id],elem);
+        fight_index_touch(b,id);
+        return st;
+    }
+
+    //Evicting may free an element, so the copy is made before anything leaves the heap
+    element copy=b->copyfunc(elem);
+    if (!copy) {return memory_error;}
+    status st=insert_with_policy(b,id,copy);
+    if (st!=success) {b->freefunc(copy);}
+    return st;
+}
+
+status setCategoryIdFunction(Battle b, getCategoryIdFunction getCategoryId) {
+    //input validation
+    if (!b) {return failure;}
+    b->getidfunc=getCategoryId;
+    return success;
+}
+
+int getCategoryId(Battle b, char* category) {
+    //input validation
+    if (!b || !category) {return -1;}
+
+    //Probing the name index from the name's hash until the name or an empty slot
+    int slot=(int)(hashCategory(category)&(unsigned long)(b->name_slots-1));
+    while (b->name_index[slot]!=-1) {
+        if (strcmp(b->names[b->name_index[slot]],category)==0) {return b->name_index[slot];}
+        slot=(slot+1)&(b->name_slots-1);
+    }
+    return -1;
+}
+
 status insertObject(Battle b, element elem) {
     //input validation
     if (!b || !elem) {return failure;}
 
-    //Checking the element's category
-    char* temp_category=b->getcatfunc(elem);
-    if (!temp_category) {return failure;}
+    int id = category_id(b,elem);
+    if (id<0) {return failure;}
+    return insert_copy(b,id,elem);
+}
 
-    //Finding the relevant link in the linked list into which we will insert the desired element
-    MaxHeap temp_h = searchByKeyInList(b->category_l_list,temp_category);
-    if (!temp_h) {return failure;}
+status insertObjectById(Battle b, int id, element elem) {
+    //input validation
+    if (!b || !elem || id<0 || id>=b->num_ids) {return failure;}
+    return insert_copy(b,id,elem);
+}
 
-    //Inserting into the heap and returning the status whether the insertion was successful or not
-    return insertToHeap(temp_h,elem);
+status insertObjectOwned(Battle b, element elem) {
+    //input validation
+    if (!b || !elem) {return failure;}
+
+    int id = category_id(b,elem);
+    if (id<0) {return failure;}
+
+    //Handing the element itself to the heap
+    return insert_with_policy(b,id,elem);
+}
+
+status insertObjectsBulk(Battle b, element* elems, int n) {
+    //input validation
+    if (!b || (!elems && n>0) || n<0) {return failure;}
+    if (n==0) {return success;}
+
+    //owners[i] is the category id of elems[i], counts[id] the number of batch elements in a category.
+    int* owners=(int*)malloc(sizeof(int)*n);
+    int* counts=(int*)calloc(b->num_ids+1,sizeof(int));
+    element* sorted=(element*)malloc(sizeof(element)*n);
+    if (!owners || !counts || !sorted) {
+        free(owners);
+        free(counts);
+        free(sorted);
+        return memory_error;
+    }
+
+    //First pass: resolving the category of every element. Nothing is adopted yet, so a failure leaves the batch to the caller.
+    status st=success;
+    for (int i=0; i<n && st==success; i++) {
+        owners[i]=elems[i] ? category_id(b,elems[i]) : -1;
+        if (owners[i]<0) {
+            st=failure;
+            break;
+        }
+        counts[owners[i]]++;
+    }
+
+    //Second pass: reserving room in every heap so the insertions below cannot fail halfway.
+    for (int id=0; id<b->num_ids && st==success; id++) {
+        if (counts[id]==0) {continue;}
+        int room=counts[id];
+        int size=getHeapCurrentSize(b->heaps[id]);
+        if (b->capacity!=UNBOUNDED_CAPACITY && size+room>b->capacity) {
+            room=b->capacity-size>0 ? b->capacity-size : 0;
+        }
+        st=reserveHeap(b->heaps[id],size+room);
+    }
+    if (st!=success) {
+        free(owners);
+        free(counts);
+        free(sorted);
+        return st;
+    }
+
+    //Grouping the elements by category (stable counting sort, so file order decides who fits in a full category)
+    int offset=0;
+    for (int id=0; id<b->num_ids; id++) {
+        int temp=counts[id];
+        counts[id]=offset;
+        offset+=temp;
+    }
+    for (int i=0; i<n; i++) {
+        sorted[counts[owners[i]]]=elems[i];
+        counts[owners[i]]++;
+    }
+
+    //Heapifying each category once. Elements beyond a category capacity are freed,
+    //or under evict_weakest replace the weakest ones they beat. Only a freed batch element makes the batch incomplete.
+    int start=0;
+    for (int id=0; id<b->num_ids; id++) {
+        int take=counts[id]-start;
+        if (take==0) {continue;}
+        MaxHeap heap=b->heaps[id];
+        int size=getHeapCurrentSize(heap);
+        if (b->capacity!=UNBOUNDED_CAPACITY && size+take>b->capacity) {
+            take=b->capacity-size>0 ? b->capacity-size : 0;
+        }
+        heapifyBulk(heap,sorted+start,take);
+        for (int i=start+take; i<counts[id]; i++) {
+            if (b->policy!=evict_weakest || insert_with_policy(b,id,sorted[i])!=success) {
+                b->freefunc(sorted[i]);
+                st=failure_fullcapacity;
+            }
+        }
+        start=counts[id];
+    }
+    fight_index_rebuild(b);
+
+    free(owners);
+    free(counts);
+    free(sorted);
+    return st;
+}
+
+status mergeCategories(Battle dst, Battle src, char* categories) {
+    //input validation
+    if (!dst || !src || !categories || dst==src || dst->eqlfunc!=src->eqlfunc || dst->freefunc!=src->freefunc) {return failure;}
+
+    char* temp_category=(char*)malloc(strlen(categories)+1);
+    if (!temp_category) {return memory_error;}
+
+    //First pass: every category must exist on both sides and fit in dst, and dst reserves the room,
+    //so the melds below cannot fail halfway and leave some categories merged
+    status st=success;
+    strcpy(temp_category,categories);
+    char* token = strtok(temp_category,",");
+    while (token!=NULL && st==success) {
+        int to_id = getCategoryId(dst,token);
+        int from_id = getCategoryId(src,token);
+        if (to_id<0 || from_id<0) {
+            st=failure;
+            break;
+        }
+        st=reserveHeap(dst->heaps[to_id],getHeapCurrentSize(dst->heaps[to_id])+getHeapCurrentSize(src->heaps[from_id]));
+        token = strtok(NULL,",");
+    }
+
+    //Second pass: moving the elements, no element is copied and each category is rebuilt once
+    if (st==success) {
+        strcpy(temp_category,categories);
+        token = strtok(temp_category,",");
+        while (token!=NULL) {
+            meldHeaps(dst->heaps[getCategoryId(dst,token)],src->heaps[getCategoryId(src,token)]);
+            token = strtok(NULL,",");
+        }
+        fight_index_rebuild(dst);
+        fight_index_rebuild(src);
+    }
+    free(temp_category);
+    return st;
+}
+
+status forEachCategory(Battle b, visitFunction visit, element ctx) {
+    //input validation
+    if (!b || !visit) {return failure;}
+    return forEachInList(b->category_l_list,visit,ctx);
+}
+
+status mergeBattle(Battle dst, Battle src) {
+    //input validation
+    if (!dst || !src) {return failure;}
+    return mergeCategories(dst,src,src->categories);
 }
 
 void displayObjectsByCategories(Battle b) {
@@ -219,112 +775,1142 @@ element removeMaxByCategory(Battle b,char* category) {
     //input validation
     if (!b || !category) {return NULL;}
 
-    //Finding the relevant heap in the linked list
-    MaxHeap temp_h = searchByKeyInList(b->category_l_list,category);
-    if (!temp_h) {return NULL;}
+    //Finding the relevant heap through its id
+    int id = getCategoryId(b,category);
+    if (id<0) {return NULL;}
 
     //Remove the strongest element from the current heap and return it to the user
-    element strongest = PopMaxHeap(temp_h);
+    element strongest = PopMaxHeap(b->heaps[id]);
     if (!strongest) {return NULL;}
+    fight_index_touch(b,id);
     return strongest;
 }
 
-int getNumberOfObjectsInCategory(Battle b,char* category) {
+element removeMaxById(Battle b, int id) {
+    //input validation
+    if (!b || id<0 || id>=b->num_ids) {return NULL;}
+    element strongest = PopMaxHeap(b->heaps[id]);
+    if (strongest) {fight_index_update(b,id);}
+    return strongest;
+}
+
+element removeObjectByKey(Battle b, char* category, element key, equalFunction match) {
+    //input validation
+    if (!b || !category || !key || !match) {return NULL;}
+
+    //Finding the relevant heap through its id
+    int id = getCategoryId(b,category);
+    if (id<0) {return NULL;}
+    MaxHeap temp_h = b->heaps[id];
+
+    //Locating the element once and removing it through its handle, the rest of the heap is not rebuilt
+    int handle = findHandleInHeap(temp_h,key,match);
+    if (handle<0) {return NULL;}
+    element removed = removeByHandle(temp_h,handle);
+    fight_index_touch(b,id);
+    return removed;
+}
+
+status updateObjectByKey(Battle b, char* category, element key, equalFunction match, updateFunction update, element arg) {
+    //input validation
+    if (!b || !category || !key || !match || !update) {return failure;}
+
+    //Finding the relevant heap through its id
+    int id = getCategoryId(b,category);
+    if (id<0) {return failure;}
+    MaxHeap temp_h = b->heaps[id];
+
+    int handle = findHandleInHeap(temp_h,key,match);
+    if (handle<0) {return failure;}
+
+    //Changing the element in place and moving it to its new place in the heap
+    status st = update(getByHandle(temp_h,handle),arg);
+    updateKey(temp_h,handle);
+    //The top may be the same element with a new key, so the category counts as changed either way
+    fight_index_update(b,id);
+    return st;
+}
+
+int topKByCategory(Battle b, char* category, int k, element out[]) {
     //input validation
     if (!b || !category) {return -1;}
 
-    //Finding the relevant heap in the linked list
-    MaxHeap temp_h = searchByKeyInList(b->category_l_list,category);
-    if (!temp_h) {return 0;}
+    //Finding the relevant heap through its id
+    int id = getCategoryId(b,category);
+    if (id<0) {return -1;}
 
-    return getHeapCurrentSize(temp_h);
+    return topKMaxHeap(b->heaps[id],k,out);
 }
 
-element fight(Battle b,element elem) {
-    if (!b || !elem) {return NULL;}
+element topOverall(Battle b) {
+    //input validation
+    if (!b) {return NULL;}
+    int id=b->leader_tree[1];
+    return id>=0 ? b->tops[id] : NULL;
+}
 
-    char* temp_category=(char*)malloc(strlen(b->categories)+1);
-    if (!temp_category) {return NULL;}
-    strcpy(temp_category,b->categories);
+element popOverall(Battle b) {
+    //input validation
+    if (!b) {return NULL;}
+    int id=b->leader_tree[1];
+    if (id<0 || !b->tops[id]) {return NULL;}
+    return removeMaxById(b,id);
+}
 
-    char* token = strtok(temp_category,",");
-    if (!token) {
-        free(temp_category);
+/**
+ * A read-only walk over all elements of a battle from strongest to weakest: a k-way merge of one ordered
+ * iterator per category, with a tournament tree over the categories' next elements (heads) as the frontier.
+ */
+struct BattleIterator_s {
+    Battle b;
+    HeapIterator* its;
+    element* heads;
+    int* tree;
+};
+
+BattleIterator createBattleIterator(Battle b) {
+    //input validation
+    if (!b) {return NULL;}
+
+    BattleIterator it=(BattleIterator)malloc(sizeof(struct BattleIterator_s));
+    if (!it) {return NULL;}
+    it->b=b;
+    it->its=(HeapIterator*)calloc(b->num_ids+1,sizeof(HeapIterator));
+    it->heads=(element*)calloc(b->leader_leaves,sizeof(element));
+    it->tree=(int*)malloc(sizeof(int)*2*b->leader_leaves);
+    if (!it->its || !it->heads || !it->tree) {
+        destroyBattleIterator(it);
         return NULL;
     }
 
-    MaxHeap temp_h;
-    element current;
-    element strongest=NULL;
-    int best_c_atk=0;
-    int best_e_atk=0;
-    int curr_c_atk;
-    int curr_e_atk;
+    //Only non-empty categories get a cursor, its first element is the category top
+    for (int id=0; id<b->num_ids; id++) {
+        if (!b->tops[id]) {continue;}
+        it->its[id]=createHeapIterator(b->heaps[id]);
+        if (!it->its[id]) {
+            destroyBattleIterator(it);
+            return NULL;
+        }
+        it->heads[id]=nextInHeapIterator(it->its[id]);
+    }
+    for (int id=0; id<b->leader_leaves; id++) {it->tree[b->leader_leaves+id]=id;}
+    for (int n=b->leader_leaves-1; n>=1; n--) {
+        it->tree[n]=head_winner(b,it->heads,it->tree[2*n],it->tree[2*n+1]);
+    }
+    return it;
+}
+
+element nextInBattleIterator(BattleIterator it) {
+    //input validation
+    if (!it) {return NULL;}
+
+    int id=it->tree[1];
+    if (id<0) {return NULL;}
+
+    //The winning category advances its cursor and replays its matches
+    element elem=it->heads[id];
+    it->heads[id]=nextInHeapIterator(it->its[id]);
+    head_replay(it->b,it->heads,it->tree,it->b->leader_leaves,id);
+    return elem;
+}
+
+void destroyBattleIterator(BattleIterator it) {
+    if (!it) {return;}
+    for (int id=0; it->its && id<it->b->num_ids; id++) {destroyHeapIterator(it->its[id]);}
+    free(it->its);
+    free(it->heads);
+    free(it->tree);
+    free(it);
+}
+
+int topNOverall(Battle b, int n, element out[]) {
+    //input validation
+    if (!b || n<0 || (!out && n>0)) {return -1;}
+
+    BattleIterator it=createBattleIterator(b);
+    if (!it) {return -1;}
 
-    int diff=0;
-    int total=0;
+    int count=0;
+    while (count<n) {
+        element elem=nextInBattleIterator(it);
+        if (!elem) {break;}
+        out[count]=elem;
+        count++;
+    }
+    destroyBattleIterator(it);
+    return count;
+}
+
+int getNumberOfObjectsInCategory(Battle b,char* category) {
+    //input validation
+    if (!b || !category) {return -1;}
+
+    //Finding the relevant heap through its id
+    int id = getCategoryId(b,category);
+    if (id<0) {return 0;}
+
+    return getHeapCurrentSize(b->heaps[id]);
+}
+
+/**
+ * The state of one fight while the categories are scanned: the opponent and the best candidate so far.
+ */
+typedef struct FightState_s {
+    Battle b;
+    element elem;
+    element strongest;
+    int best_c_atk;
+    int best_e_atk;
+    int diff;
+    int total;
     // f serves as a flag for me and ensures that if all candidates are weaker than the opponent,
     // we will still put the least bad option in the fight against him.
-    bool f=false;
+    bool f;
+} FightState;
 
-    while (token!=NULL) {
-        temp_h = searchByKeyInList(b->category_l_list,token);
-        if (temp_h==NULL) {
-            free(temp_category);
-            return NULL;
+/**
+ * Auxiliary function for self use only.
+ * Category visitor of fight: matches the strongest element of a category against the opponent
+ * and keeps it if it does better than the candidates of the previous categories.
+ * @param e_heap The generic element (MaxHeap) of the category.
+ * @param ctx A pointer to the FightState.
+ * @return true, every category is visited.
+ */
+static bool fightVisit(element e_heap, element ctx) {
+    FightState* state=(FightState*)ctx;
+    MaxHeap temp_h=(MaxHeap)e_heap;
+    int curr_c_atk;
+    int curr_e_atk;
+
+    state->total+=getHeapCurrentSize(temp_h);
+
+    element current = TopMaxHeap(temp_h);
+    if (!current) {return true;}
+
+    int curr_diff = state->b->getatkfunc(current,state->elem,&curr_c_atk,&curr_e_atk);
+    if (curr_diff>state->diff || state->f==false) {
+        state->f=true;
+        state->diff = curr_diff;
+        state->strongest=current;
+        state->best_c_atk=curr_c_atk;
+        state->best_e_atk=curr_e_atk;
+    }
+    return true;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Finds the opponent of a fight through the fight index, with the result of the category scan:
+ * the lowest category id whose top gets the best attack difference against elem.
+ * In each group the best difference belongs to the tree's winner, and the lowest id reaching a difference
+ * is found by walking down the tree, so getatkfunc runs O(groups * log categories) times.
+ * @param b The battle, with the fight index enabled.
+ * @param elem The challenger.
+ * @param state The fight state to fill (strongest stays NULL if every category is empty).
+ * @return true if the index answered, false if elem's class is unknown and the categories must be scanned.
+ */
+static bool fight_index_query(Battle b, element elem, FightState* state) {
+    int k=b->challengerfunc(elem);
+    if (k<0 || k>=b->num_ids) {return false;}
+    int curr_c_atk;
+    int curr_e_atk;
+
+    //The best difference of every group, from the strongest top of the group
+    int best_diff=0;
+    bool found=false;
+    for (int g=0; g<b->fight_groups; g++) {
+        int* tree=b->fight_tree+(size_t)(k*b->fight_groups+g)*2*b->fight_leaves;
+        if (tree[1]<0 || !b->tops[tree[1]]) {continue;}
+        int d=b->getatkfunc(b->tops[tree[1]],elem,&curr_c_atk,&curr_e_atk);
+        if (!found || d>best_diff) {best_diff=d;}
+        found=true;
+    }
+    if (!found) {return true;}
+
+    //The lowest id reaching best_diff: in each group that reaches it, the leftmost subtree whose winner reaches it
+    int best_id=-1;
+    for (int g=0; g<b->fight_groups; g++) {
+        int* tree=b->fight_tree+(size_t)(k*b->fight_groups+g)*2*b->fight_leaves;
+        if (tree[1]<0 || !b->tops[tree[1]]) {continue;}
+        if (b->getatkfunc(b->tops[tree[1]],elem,&curr_c_atk,&curr_e_atk)!=best_diff) {continue;}
+        int n=1;
+        while (n<b->fight_leaves) {
+            int left=tree[2*n];
+            bool go_left=left>=0 && b->tops[left] && b->getatkfunc(b->tops[left],elem,&curr_c_atk,&curr_e_atk)==best_diff;
+            n=go_left ? 2*n : 2*n+1;
         }
+        if (best_id<0 || tree[n]<best_id) {best_id=tree[n];}
+    }
 
-        total+=getHeapCurrentSize(temp_h);
+    state->strongest=b->tops[best_id];
+    state->diff=b->getatkfunc(state->strongest,elem,&state->best_c_atk,&state->best_e_atk);
+    state->total=1;
+    state->f=true;
+    return true;
+}
 
-        current = TopMaxHeap(temp_h);
-        if (!current) {
-            token = strtok(NULL,",");
-            continue;
+status enableFightIndex(Battle b, getCategoryIdFunction challengerClass, int numGroups, fightGroupFunction group, element ctx) {
+    //input validation
+    if (!b || !challengerClass || !group || numGroups<=0) {return failure;}
+
+    //Leaves for the ids, rounded up to a power of two
+    int leaves=1;
+    while (leaves<b->num_ids) {leaves*=2;}
+    int* groups=(int*)malloc(sizeof(int)*(b->num_ids*b->num_ids+1));
+    int* tree=(int*)malloc(sizeof(int)*((size_t)b->num_ids*numGroups*2*leaves+1));
+    if (!groups || !tree) {
+        free(groups);
+        free(tree);
+        return memory_error;
+    }
+
+    //The group of every category for every challenger class is fixed, it is asked once
+    for (int k=0; k<b->num_ids; k++) {
+        for (int id=0; id<b->num_ids; id++) {
+            int g=group(id,k,ctx);
+            if (g<0 || g>=numGroups) {
+                free(groups);
+                free(tree);
+                return failure;
+            }
+            groups[k*b->num_ids+id]=g;
+        }
+    }
+
+    free(b->fight_tree);
+    free(b->fight_group);
+    b->fight_tree=tree;
+    b->fight_group=groups;
+    b->fight_leaves=leaves;
+    b->fight_groups=numGroups;
+    b->challengerfunc=challengerClass;
+    fight_index_rebuild(b);
+    return success;
+}
+
+status enableFightCache(Battle b, getCategoryIdFunction challengerClass, getKeyFunction challengerKey, int slots) {
+    //input validation
+    if (!b || (slots>0 && (!challengerClass || !challengerKey))) {return failure;}
+
+    FightCacheEntry* cache=NULL;
+    if (slots>0) {
+        cache=(FightCacheEntry*)calloc(slots,sizeof(FightCacheEntry));
+        if (!cache) {return memory_error;}
+    }
+    free(b->fight_cache);
+    b->fight_cache=cache;
+    b->cache_slots=slots>0 ? slots : 0;
+    b->cacheclassfunc=challengerClass;
+    b->cachekeyfunc=challengerKey;
+    return success;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Finds the cache slot of a challenger profile.
+ * @param b The battle, with the fight cache enabled.
+ * @param challengerClass The challenger's class.
+ * @param challengerKey The challenger's key.
+ * @return The slot the profile maps to (it may hold another profile).
+ */
+static FightCacheEntry* fight_cache_slot(Battle b, int challengerClass, int challengerKey) {
+    unsigned long h=(unsigned long)(unsigned)challengerClass*31+(unsigned)challengerKey;
+    h*=2654435761UL;
+    return &b->fight_cache[(h>>8)%(unsigned long)b->cache_slots];
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Decides a fight without printing, answering a repeated challenger profile from the fight cache
+ * while no category top changed since it was fought.
+ * @param b The battle.
+ * @param elem The challenger.
+ * @param result The result to fill.
+ * @param remember true to store a new result in the cache, false to only read it (as the workers of fightBatch do).
+ */
+static void fight_query(Battle b, element elem, FightResult* result, bool remember) {
+    FightCacheEntry* entry=NULL;
+    int challenger_class=0;
+    int challenger_key=0;
+    if (b->fight_cache) {
+        challenger_class=b->cacheclassfunc(elem);
+        challenger_key=b->cachekeyfunc(elem);
+        entry=fight_cache_slot(b,challenger_class,challenger_key);
+        if (entry->valid && entry->version==b->version && entry->challenger_class==challenger_class && entry->challenger_key==challenger_key) {
+            *result=entry->result;
+            if (result->outcome==challenger_won) {result->winner=elem;}
+            return;
         }
+    }
 
-        int curr_diff = b->getatkfunc(current,elem,&curr_c_atk,&curr_e_atk);
-        if (curr_diff>diff || f==false) {
-            f=true;
-            diff = curr_diff;
-            strongest=current;
-            best_c_atk=curr_c_atk;
-            best_e_atk=curr_e_atk;
+    //choose the opponent through the fight index if there is one, otherwise scan the categories in order
+    FightState state={b,elem,NULL,0,0,0,0,false};
+    if (!b->fight_tree || !fight_index_query(b,elem,&state)) {
+        for (int id=0; id<b->num_ids; id++) {
+            fightVisit(b->heaps[id],&state);
         }
-        token = strtok(NULL,",");
     }
 
+    result->opponent=state.strongest;
+    result->challengerAttack=state.best_e_atk;
+    result->opponentAttack=state.best_c_atk;
+
     // There is no enemies in the system to fight against 'elem'.
-    if (total==0 || strongest==NULL) {
-        free(temp_category);
-        return (element)-1;
+    if (state.total==0 || state.strongest==NULL) {
+        result->winner=NULL;
+        result->outcome=no_opponent;
+    } else if (state.diff>0) {
+        result->winner=state.strongest;
+        result->outcome=challenger_lost;
+    } else if (state.diff<0) {
+        result->winner=elem;
+        result->outcome=challenger_won;
+    } else {
+        result->winner=NULL;
+        result->outcome=fight_draw;
     }
+    if (entry && remember) {
+        entry->valid=true;
+        entry->challenger_class=challenger_class;
+        entry->challenger_key=challenger_key;
+        entry->version=b->version;
+        entry->result=*result;
+    }
+}
+
+status fightQuery(Battle b, element elem, FightResult* result) {
+    if (!b || !elem || !result) {return failure;}
+    fight_query(b,elem,result,true);
+    return success;
+}
+
+element fight(Battle b,element elem) {
+    if (!b || !elem) {return NULL;}
+
+    FightResult result;
+    if (fightQuery(b,elem,&result)!=success || result.outcome==no_opponent) {return (element)-1;}
+    element strongest=result.opponent;
 
     //prints part
     printf("The final battle between:\n");
     b->printfunc(elem);
-    printf("In this battle his attack is :%d\n\n",best_e_atk);
+    printf("In this battle his attack is :%d\n\n",result.challengerAttack);
     printf("against ");
     b->printfunc(strongest);
-    printf("In this battle his attack is :%d\n\n",best_c_atk);
+    printf("In this battle his attack is :%d\n\n",result.opponentAttack);
 
-    if (diff>0) {
+    if (result.outcome==challenger_lost) {
         printf("THE WINNER IS:\n");
         b->printfunc(strongest);
-        free(temp_category);
         return strongest;
     }
-    if (diff<0) {
+    if (result.outcome==challenger_won) {
         printf("THE WINNER IS:\n");
         b->printfunc(elem);
-        free(temp_category);
         return elem;
     }
     printf("IT IS A DRAW.\n");
-    free(temp_category);
     return strongest;
 }
 
+/**
+ * Auxiliary function for self use only.
+ * Decides the fights of one chunk of a fight batch.
+ * @param chunk The chunk.
+ */
+static void fight_chunk(FightChunk* chunk) {
+    for (int i=chunk->from; i<chunk->to; i++) {
+        fight_query(chunk->b,chunk->challengers[i],&chunk->results[i],false);
+    }
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Takes the next queued chunk of the current batch and decides its fights, for as long as chunks are queued.
+ * @param pool The pool, its lock held by the caller (it is released while fights are decided).
+ */
+static void fight_pool_drain(FightPool* pool) {
+    while (pool->next_chunk<pool->num_chunks) {
+        FightChunk* chunk=&pool->chunks[pool->next_chunk];
+        pool->next_chunk++;
+        pthread_mutex_unlock(&pool->lock);
+        fight_chunk(chunk);
+        pthread_mutex_lock(&pool->lock);
+        pool->pending--;
+        if (pool->pending==0) {pthread_cond_signal(&pool->done);}
+    }
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Main loop of a worker thread of fightBatch: sleeps until a batch queues chunks or the pool shuts down.
+ * @param arg A pointer to the FightPool.
+ * @return NULL.
+ */
+static void* fight_pool_thread(void* arg) {
+    FightPool* pool=(FightPool*)arg;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->shutdown) {
+        if (pool->next_chunk==pool->num_chunks) {
+            pthread_cond_wait(&pool->work,&pool->lock);
+            continue;
+        }
+        fight_pool_drain(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Starts the worker threads of fightBatch once per battle.
+ * @param b The battle.
+ * @param threads The number of threads wanted.
+ * @return The pool, or NULL if it could not be set up (the batch then runs on the calling thread).
+ */
+static FightPool* fight_pool_start(Battle b, int threads) {
+    if (b->fight_pool) {return b->fight_pool;}
+    FightPool* pool=(FightPool*)calloc(1,sizeof(FightPool));
+    if (!pool) {return NULL;}
+    if (pthread_mutex_init(&pool->lock,NULL)!=0) {
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->work,NULL)!=0) {
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->done,NULL)!=0) {
+        pthread_cond_destroy(&pool->work);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    //A thread that cannot start only leaves more chunks to the others and to the calling thread
+    while (pool->num_threads<threads && pthread_create(&pool->threads[pool->num_threads],NULL,fight_pool_thread,pool)==0) {
+        pool->num_threads++;
+    }
+    b->fight_pool=pool;
+    return pool;
+}
+
+static void fight_pool_stop(FightPool* pool) {
+    if (!pool) {return;}
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown=true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (int t=0; t<pool->num_threads; t++) {pthread_join(pool->threads[t],NULL);}
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+status fightBatch(Battle b, element* challengers, int n, FightResult* results) {
+    //input validation
+    if (!b || n<0 || (n>0 && (!challengers || !results))) {return failure;}
+    for (int i=0; i<n; i++) {
+        if (!challengers[i]) {return failure;}
+    }
+
+    //One chunk per core, as long as each is worth a thread
+    long cores=sysconf(_SC_NPROCESSORS_ONLN);
+    int workers=cores>0 ? (int)cores : 1;
+    if (workers>FIGHT_MAX_THREADS) {workers=FIGHT_MAX_THREADS;}
+    int chunks=workers;
+    if (chunks>n/FIGHT_MIN_CHUNK) {chunks=n/FIGHT_MIN_CHUNK;}
+    if (chunks<1) {chunks=1;}
+
+    //A small batch is decided on the calling thread, a larger one is shared with the pool (started once, sized by the cores)
+    FightPool* pool = chunks>1 ? fight_pool_start(b,workers-1) : NULL;
+    if (!pool) {
+        FightChunk all={b,challengers,results,0,n};
+        fight_chunk(&all);
+        return success;
+    }
+
+    //Queuing the chunks and taking part in the batch until every chunk is done
+    pthread_mutex_lock(&pool->lock);
+    for (int c=0; c<chunks; c++) {
+        pool->chunks[c]=(FightChunk){b,challengers,results,(int)((long)n*c/chunks),(int)((long)n*(c+1)/chunks)};
+    }
+    pool->next_chunk=0;
+    pool->num_chunks=chunks;
+    pool->pending=chunks;
+    pthread_cond_broadcast(&pool->work);
+    fight_pool_drain(pool);
+    while (pool->pending>0) {pthread_cond_wait(&pool->done,&pool->lock);}
+    pool->next_chunk=0;
+    pool->num_chunks=0;
+    pthread_mutex_unlock(&pool->lock);
+    return success;
+}
+
+/**
+ * The header of a snapshot file. Nothing in the file is a pointer, every part is found from the sizes
+ * in the header, so the file can be mapped at any address. After the header come the categories string,
+ * the user's meta bytes, and for every category in id order a SnapshotLength with its number of elements
+ * followed by its elements in heap storage order, each a SnapshotLength with its byte size followed by its bytes.
+ * Every part is padded to SNAPSHOT_ALIGN, so records can be read in place.
+ */
+typedef struct SnapshotHeader_s {
+    char magic[8];
+    int num_categories;
+    int categories_size;
+    int meta_size;
+    int total_elements;
+    long long file_size;
+} SnapshotHeader;
 
+/**
+ * A count or a byte size inside a snapshot, padded to SNAPSHOT_ALIGN.
+ */
+typedef struct SnapshotLength_s {
+    int value;
+    int pad;
+} SnapshotLength;
 
+/**
+ * A snapshot file mapped into memory (privately, changes never reach the file), checked to be complete.
+ */
+struct BattleSnapshot_s {
+    char* data;
+    size_t size;
+    SnapshotHeader* header;
+    long long elements_offset;
+};
 
+/**
+ * Auxiliary function for self use only.
+ * @param n A number of bytes.
+ * @return n rounded up to a multiple of SNAPSHOT_ALIGN.
+ */
+static long long snapshot_pad(long long n) {
+    return (n+SNAPSHOT_ALIGN-1)/SNAPSHOT_ALIGN*SNAPSHOT_ALIGN;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Writes bytes to a snapshot file followed by zeros up to the next multiple of SNAPSHOT_ALIGN.
+ * @param f The file.
+ * @param bytes The bytes to write.
+ * @param size The number of bytes.
+ * @param offset The current file offset, moved past the padded bytes.
+ * @return success, or failure if the write failed.
+ */
+static status snapshot_write(FILE* f, const void* bytes, int size, long long* offset) {
+    static const char zeros[SNAPSHOT_ALIGN]={0};
+    int pad=(int)(snapshot_pad(size)-size);
+    if ((size>0 && fwrite(bytes,1,size,f)!=(size_t)size) || (pad>0 && fwrite(zeros,1,pad,f)!=(size_t)pad)) {return failure;}
+    *offset+=size+pad;
+    return success;
+}
+
+status saveBattleSnapshot(Battle b, char* path, element meta, int metaSize, serializeFunction serialize, element ctx) {
+    //input validation
+    if (!b || !path || !serialize || metaSize<0 || (!meta && metaSize>0)) {return failure;}
+
+    //The snapshot is written aside and renamed over path once complete, so path never holds half a snapshot
+    char* temp_path=(char*)malloc(strlen(path)+5);
+    int slots=256;
+    char* buffer=(char*)malloc(slots);
+    if (!temp_path || !buffer) {
+        free(temp_path);
+        free(buffer);
+        return memory_error;
+    }
+    sprintf(temp_path,"%s.tmp",path);
+    FILE* f=fopen(temp_path,"wb");
+    if (!f) {
+        free(temp_path);
+        free(buffer);
+        return failure;
+    }
 
+    SnapshotHeader header;
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,SNAPSHOT_MAGIC,sizeof(header.magic));
+    header.num_categories=b->num_ids;
+    header.categories_size=(int)strlen(b->categories)+1;
+    header.meta_size=metaSize;
+    for (int id=0; id<b->num_ids; id++) {header.total_elements+=getHeapCurrentSize(b->heaps[id]);}
+
+    //The header goes first with file_size still 0 and is rewritten at the end
+    long long offset=0;
+    status st=snapshot_write(f,&header,sizeof(header),&offset);
+    if (st==success) {st=snapshot_write(f,b->categories,header.categories_size,&offset);}
+    if (st==success) {st=snapshot_write(f,meta,metaSize,&offset);}
+    for (int id=0; id<b->num_ids && st==success; id++) {
+        int count=getHeapCurrentSize(b->heaps[id]);
+        SnapshotLength length={count,0};
+        st=snapshot_write(f,&length,sizeof(length),&offset);
+        for (int pos=0; pos<count && st==success; pos++) {
+            element elem=getHeapSlot(b->heaps[id],pos);
+            int size=serialize(elem,buffer,slots,ctx);
+            //An element larger than the buffer is serialized again into a buffer that fits it
+            if (size>slots) {
+                char* temp=(char*)realloc(buffer,size);
+                if (!temp) {
+                    st=memory_error;
+                    break;
+                }
+                buffer=temp;
+                slots=size;
+                size=serialize(elem,buffer,slots,ctx);
+            }
+            if (size<0 || size>slots) {
+                st=failure;
+                break;
+            }
+            length.value=size;
+            st=snapshot_write(f,&length,sizeof(length),&offset);
+            if (st==success) {st=snapshot_write(f,buffer,size,&offset);}
+        }
+    }
+    if (st==success) {
+        header.file_size=offset;
+        offset=0;
+        if (fseek(f,0,SEEK_SET)!=0) {st=failure;}
+        if (st==success) {st=snapshot_write(f,&header,sizeof(header),&offset);}
+        if (st==success && (fflush(f)!=0 || fsync(fileno(f))!=0)) {st=failure;}
+    }
+    if (fclose(f)!=0 && st==success) {st=failure;}
+    if (st==success && rename(temp_path,path)!=0) {st=failure;}
+    if (st!=success) {remove(temp_path);}
+    free(temp_path);
+    free(buffer);
+    return st;
+}
+
+BattleSnapshot openBattleSnapshot(char* path) {
+    //input validation
+    if (!path) {return NULL;}
+
+    int fd=open(path,O_RDONLY);
+    if (fd<0) {return NULL;}
+    struct stat info;
+    if (fstat(fd,&info)!=0 || info.st_size<(off_t)sizeof(SnapshotHeader)) {
+        close(fd);
+        return NULL;
+    }
+    //A private mapping: the caller may write into it (e.g. strtok the categories), the file never changes
+    char* data=(char*)mmap(NULL,info.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);
+    close(fd);
+    if (data==MAP_FAILED) {return NULL;}
+
+    BattleSnapshot snap=(BattleSnapshot)malloc(sizeof(struct BattleSnapshot_s));
+    if (!snap) {
+        munmap(data,info.st_size);
+        return NULL;
+    }
+    snap->data=data;
+    snap->size=info.st_size;
+    snap->header=(SnapshotHeader*)data;
+
+    //Checking every size once against the file, so loading can trust them
+    SnapshotHeader* header=snap->header;
+    long long size=(long long)info.st_size;
+    bool ok=memcmp(header->magic,SNAPSHOT_MAGIC,sizeof(header->magic))==0 && header->file_size==size
+        && header->num_categories>=0 && header->categories_size>0 && header->meta_size>=0 && header->total_elements>=0;
+    long long offset=snapshot_pad(sizeof(SnapshotHeader));
+    if (ok) {
+        ok=offset+header->categories_size<=size && data[offset+header->categories_size-1]=='\0';
+        offset+=snapshot_pad(header->categories_size)+snapshot_pad(header->meta_size);
+    }
+    snap->elements_offset=offset;
+    long long total=0;
+    for (int id=0; ok && id<header->num_categories; id++) {
+        ok=offset+(long long)sizeof(SnapshotLength)<=size;
+        if (!ok) {break;}
+        int count=((SnapshotLength*)(data+offset))->value;
+        offset+=sizeof(SnapshotLength);
+        ok=count>=0;
+        for (int i=0; ok && i<count; i++) {
+            ok=offset+(long long)sizeof(SnapshotLength)<=size;
+            if (!ok) {break;}
+            int bytes=((SnapshotLength*)(data+offset))->value;
+            offset+=sizeof(SnapshotLength);
+            ok=bytes>=0 && offset+snapshot_pad(bytes)<=size;
+            offset+=snapshot_pad(bytes);
+        }
+        total+=count;
+    }
+    if (!ok || offset!=size || total!=header->total_elements) {
+        closeBattleSnapshot(snap);
+        return NULL;
+    }
+    return snap;
+}
+
+char* getSnapshotCategories(BattleSnapshot snap) {
+    if (!snap) {return NULL;}
+    return snap->data+snapshot_pad(sizeof(SnapshotHeader));
+}
+
+element getSnapshotMeta(BattleSnapshot snap, int* metaSize) {
+    if (!snap) {return NULL;}
+    if (metaSize) {*metaSize=snap->header->meta_size;}
+    return snap->data+snapshot_pad(sizeof(SnapshotHeader))+snapshot_pad(snap->header->categories_size);
+}
+
+status loadBattleSnapshot(Battle b, BattleSnapshot snap, deserializeFunction deserialize, element ctx) {
+    //input validation
+    if (!b || !snap || !deserialize) {return failure;}
+    SnapshotHeader* header=snap->header;
+    if (header->num_categories!=b->num_ids || strcmp(getSnapshotCategories(snap),b->categories)!=0) {return failure;}
+
+    //First pass: creating every element, nothing is adopted yet so a failure leaves the battle unchanged
+    element* elems=(element*)malloc(sizeof(element)*(header->total_elements+1));
+    int* counts=(int*)malloc(sizeof(int)*(b->num_ids+1));
+    if (!elems || !counts) {
+        free(elems);
+        free(counts);
+        return memory_error;
+    }
+    status st=success;
+    int created=0;
+    long long offset=snap->elements_offset;
+    for (int id=0; id<b->num_ids && st==success; id++) {
+        counts[id]=((SnapshotLength*)(snap->data+offset))->value;
+        offset+=sizeof(SnapshotLength);
+        for (int i=0; i<counts[id]; i++) {
+            int bytes=((SnapshotLength*)(snap->data+offset))->value;
+            offset+=sizeof(SnapshotLength);
+            elems[created]=deserialize(snap->data+offset,bytes,ctx);
+            if (!elems[created]) {
+                st=memory_error;
+                break;
+            }
+            created++;
+            offset+=snapshot_pad(bytes);
+        }
+    }
+
+    //Second pass: reserving room in every category so the adoptions below cannot fail halfway
+    for (int id=0; id<b->num_ids && st==success; id++) {
+        int size=getHeapCurrentSize(b->heaps[id]);
+        int room=counts[id];
+        if (b->capacity!=UNBOUNDED_CAPACITY && size+room>b->capacity) {
+            room=b->capacity-size>0 ? b->capacity-size : 0;
+        }
+        st=reserveHeap(b->heaps[id],size+room);
+    }
+    if (st!=success) {
+        for (int i=0; i<created; i++) {b->freefunc(elems[i]);}
+        free(elems);
+        free(counts);
+        return st;
+    }
+
+    //Adopting each category in its stored order with one O(n) build-heap. In an empty heap of the same kind
+    //the order is already a heap and the build only compares, a heap that holds elements or is of another
+    //kind or arity is rebuilt. The elements beyond a full category are the last ones of the stored order
+    int start=0;
+    for (int id=0; id<b->num_ids; id++) {
+        int take=counts[id];
+        int size=getHeapCurrentSize(b->heaps[id]);
+        if (b->capacity!=UNBOUNDED_CAPACITY && size+take>b->capacity) {
+            take=b->capacity-size>0 ? b->capacity-size : 0;
+            st=failure_fullcapacity;
+        }
+        heapifyBulk(b->heaps[id],elems+start,take);
+        for (int i=start+take; i<start+counts[id]; i++) {b->freefunc(elems[i]);}
+        start+=counts[id];
+    }
+    fight_index_rebuild(b);
+    free(elems);
+    free(counts);
+    return st;
+}
+
+void closeBattleSnapshot(BattleSnapshot snap) {
+    if (!snap) {return;}
+    munmap(snap->data,snap->size);
+    free(snap);
+}
+
+/**
+ * The header of a journal file, followed by its records. The generation tells which base the records
+ * apply to (see saveBattleSnapshot's meta in the callers), so records already folded into a base are never replayed.
+ */
+typedef struct JournalHeader_s {
+    char magic[8];
+    int generation;
+    int pad;
+} JournalHeader;
+
+/**
+ * The header of one journal record, followed by size bytes (the serialized element of an insertion).
+ * check covers the header fields and the bytes, so a record torn by a crash is recognized.
+ */
+typedef struct JournalRecord_s {
+    int op;
+    int id;
+    int size;
+    unsigned int check;
+} JournalRecord;
+
+/**
+ * An open journal. Records are collected in buffer before their operations are made, and written
+ * with a single write and fsync once group_size of them are pending (group commit), or on syncBattleJournal.
+ */
+struct BattleJournal_s {
+    int fd;
+    char* buffer;
+    int used;
+    int slots;
+    int pending;
+    int group_size;
+    serializeFunction serialize;
+    element ctx;
+};
+
+/**
+ * Auxiliary function for self use only.
+ * @param record A record header, its check field is ignored.
+ * @param bytes The bytes following it.
+ * @return The checksum of the record (FNV-1a over the fields and the bytes).
+ */
+static unsigned int journal_check(JournalRecord* record, const char* bytes) {
+    unsigned int h=2166136261u;
+    int fields[3]={record->op,record->id,record->size};
+    const unsigned char* p=(const unsigned char*)fields;
+    for (size_t i=0; i<sizeof(fields); i++) {h=(h^p[i])*16777619u;}
+    p=(const unsigned char*)bytes;
+    for (int i=0; i<record->size; i++) {h=(h^p[i])*16777619u;}
+    return h;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Finds where the complete records of a journal end.
+ * @param data The journal bytes.
+ * @param size The number of bytes.
+ * @return The offset just after the last complete record, or 0 if the bytes do not start with a journal header.
+ */
+static long long journal_end(char* data, long long size) {
+    if (size<(long long)sizeof(JournalHeader) || memcmp(data,JOURNAL_MAGIC,8)!=0) {return 0;}
+    long long offset=sizeof(JournalHeader);
+    while (offset+(long long)sizeof(JournalRecord)<=size) {
+        JournalRecord record;
+        memcpy(&record,data+offset,sizeof(record));
+        long long next=offset+(long long)sizeof(record)+record.size;
+        if (record.size<0 || next>size || journal_check(&record,data+offset+sizeof(record))!=record.check) {break;}
+        offset=next;
+    }
+    return offset;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Starts a journal file anew: only a header with the given generation, written and synced.
+ * @param fd The journal file descriptor.
+ * @param generation The generation of the new journal.
+ * @return success, or failure on an I/O error.
+ */
+static status journal_restart(int fd, int generation) {
+    JournalHeader header;
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,JOURNAL_MAGIC,sizeof(header.magic));
+    header.generation=generation;
+    if (ftruncate(fd,0)!=0 || pwrite(fd,&header,sizeof(header),0)!=(ssize_t)sizeof(header) || fsync(fd)!=0) {return failure;}
+    return lseek(fd,sizeof(header),SEEK_SET)<0 ? failure : success;
+}
+
+int getJournalGeneration(char* path) {
+    if (!path) {return -1;}
+    FILE* f=fopen(path,"rb");
+    if (!f) {return -1;}
+    JournalHeader header;
+    bool ok=fread(&header,sizeof(header),1,f)==1 && memcmp(header.magic,JOURNAL_MAGIC,8)==0;
+    fclose(f);
+    return ok ? header.generation : -1;
+}
+
+status replayBattleJournal(Battle b, char* path, int generation, deserializeFunction deserialize, element ctx) {
+    //input validation
+    if (!b || !path || !deserialize) {return failure;}
+
+    //A missing or foreign journal, or one of another generation, has nothing to replay
+    int fd=open(path,O_RDONLY);
+    if (fd<0) {return success;}
+    struct stat info;
+    if (fstat(fd,&info)!=0 || info.st_size<(off_t)sizeof(JournalHeader)) {
+        close(fd);
+        return success;
+    }
+    char* data=(char*)mmap(NULL,info.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);
+    close(fd);
+    if (data==MAP_FAILED) {return failure;}
+    long long end=journal_end(data,info.st_size);
+    if (end==0 || (generation!=-1 && ((JournalHeader*)data)->generation!=generation)) {
+        munmap(data,info.st_size);
+        return success;
+    }
+
+    //Applying the complete records in order, as the operations were made
+    status st=success;
+    long long offset=sizeof(JournalHeader);
+    while (offset<end && st==success) {
+        JournalRecord record;
+        memcpy(&record,data+offset,sizeof(record));
+        char* bytes=data+offset+sizeof(record);
+        if (record.op==JOURNAL_INSERT) {
+            element elem=deserialize(bytes,record.size,ctx);
+            if (!elem) {st=memory_error;}
+            else if (insertObjectOwned(b,elem)!=success) {b->freefunc(elem);}
+        } else if (record.op==JOURNAL_REMOVE_MAX) {
+            element elem=removeMaxById(b,record.id);
+            if (elem) {b->freefunc(elem);}
+        }
+        offset+=sizeof(record)+record.size;
+    }
+    munmap(data,info.st_size);
+    return st;
+}
+
+BattleJournal openBattleJournal(char* path, int generation, int groupSize, serializeFunction serialize, element ctx) {
+    //input validation
+    if (!path || !serialize || groupSize<1) {return NULL;}
+
+    BattleJournal j=(BattleJournal)malloc(sizeof(struct BattleJournal_s));
+    if (!j) {return NULL;}
+    j->fd=open(path,O_RDWR|O_CREAT,0644);
+    j->slots=256;
+    j->buffer=(char*)malloc(j->slots);
+    if (j->fd<0 || !j->buffer) {
+        if (j->fd>=0) {close(j->fd);}
+        free(j->buffer);
+        free(j);
+        return NULL;
+    }
+    j->used=0;
+    j->pending=0;
+    j->group_size=groupSize;
+    j->serialize=serialize;
+    j->ctx=ctx;
+
+    //Appending after the last complete record: a torn tail is cut off, another generation starts anew
+    status st=success;
+    struct stat info;
+    long long end=0;
+    if (fstat(j->fd,&info)!=0) {st=failure;}
+    else if (info.st_size>0) {
+        char* data=(char*)mmap(NULL,info.st_size,PROT_READ,MAP_PRIVATE,j->fd,0);
+        if (data==MAP_FAILED) {st=failure;}
+        else {
+            end=journal_end(data,info.st_size);
+            if (end>0 && ((JournalHeader*)data)->generation!=generation) {end=0;}
+            munmap(data,info.st_size);
+        }
+    }
+    if (st==success) {
+        if (end==0) {st=journal_restart(j->fd,generation);}
+        else if (ftruncate(j->fd,end)!=0 || lseek(j->fd,end,SEEK_SET)<0) {st=failure;}
+    }
+    if (st!=success) {
+        close(j->fd);
+        free(j->buffer);
+        free(j);
+        return NULL;
+    }
+    return j;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Adds a record to the journal buffer, and commits the group once group_size records are pending.
+ * @param j The journal.
+ * @param op The operation.
+ * @param id The category id.
+ * @param elem The element to serialize into the record, or NULL for none.
+ * @return success, memory_error, or failure on a serialize or I/O error.
+ */
+static status journal_append(BattleJournal j, int op, int id, element elem) {
+    JournalRecord record={op,id,0,0};
+    int header=(int)sizeof(record);
+    if (elem) {
+        //An element larger than the free part of the buffer is serialized again once the buffer fits it
+        int room=j->slots-j->used-header;
+        record.size = room>0 ? j->serialize(elem,j->buffer+j->used+header,room,j->ctx) : j->serialize(elem,j->buffer,0,j->ctx);
+        if (record.size<0) {return failure;}
+    }
+    if (j->used+header+record.size>j->slots) {
+        int slots=j->slots;
+        while (j->used+header+record.size>slots) {slots*=2;}
+        char* temp=(char*)realloc(j->buffer,slots);
+        if (!temp) {return memory_error;}
+        j->buffer=temp;
+        j->slots=slots;
+        if (elem && j->serialize(elem,j->buffer+j->used+header,record.size,j->ctx)!=record.size) {return failure;}
+    }
+    record.check=journal_check(&record,j->buffer+j->used+header);
+    memcpy(j->buffer+j->used,&record,header);
+    j->used+=header+record.size;
+    j->pending++;
+    if (j->pending<j->group_size || syncBattleJournal(j)==success) {return success;}
+
+    //The group could not be committed: this record is taken back, the rest of the group waits for the next sync
+    j->used-=header+record.size;
+    j->pending--;
+    return failure;
+}
+
+status journalInsert(BattleJournal j, element elem) {
+    //input validation
+    if (!j || !elem) {return failure;}
+    return journal_append(j,JOURNAL_INSERT,-1,elem);
+}
+
+status journalRemoveMax(BattleJournal j, int id) {
+    //input validation
+    if (!j || id<0) {return failure;}
+    return journal_append(j,JOURNAL_REMOVE_MAX,id,NULL);
+}
+
+status syncBattleJournal(BattleJournal j) {
+    //input validation
+    if (!j) {return failure;}
+    if (j->pending==0) {return success;}
+
+    //One write and one fsync for the whole group
+    off_t start=lseek(j->fd,0,SEEK_CUR);
+    if (start<0) {return failure;}
+    bool ok=true;
+    int written=0;
+    while (ok && written<j->used) {
+        ssize_t n=write(j->fd,j->buffer+written,j->used-written);
+        if (n<0) {ok=false;}
+        else {written+=(int)n;}
+    }
+    if (ok && fsync(j->fd)!=0) {ok=false;}
+
+    //A group is committed whole or not at all: what was written of it is cut off, and it stays in the buffer
+    if (!ok) {
+        if (ftruncate(j->fd,start)==0) {fsync(j->fd);}
+        lseek(j->fd,start,SEEK_SET);
+        return failure;
+    }
+    j->used=0;
+    j->pending=0;
+    return success;
+}
+
+status resetBattleJournal(BattleJournal j, int generation) {
+    //input validation
+    if (!j) {return failure;}
+    j->used=0;
+    j->pending=0;
+    return journal_restart(j->fd,generation);
+}
+
+status closeBattleJournal(BattleJournal j) {
+    if (!j) {return failure;}
+    status st=syncBattleJournal(j);
+    if (close(j->fd)!=0) {st=failure;}
+    free(j->buffer);
+    free(j);
+    return st;
+}
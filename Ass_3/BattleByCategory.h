@@ -6,12 +6,41 @@
 /* Pointer to Battle ADT. */
 typedef struct battle_s* Battle;
 
+/* Pointer to a read-only iterator over all the elements of a Battle, strongest first. */
+typedef struct BattleIterator_s* BattleIterator;
+
+/* Pointer to a snapshot file of a Battle mapped into memory. */
+typedef struct BattleSnapshot_s* BattleSnapshot;
+
+/* Pointer to an open append-only journal of Battle operations. */
+typedef struct BattleJournal_s* BattleJournal;
+
+/* How a fight ended, seen from the challenger. */
+typedef enum e_outcome {no_opponent, challenger_lost, challenger_won, fight_draw} fightOutcome;
+
+/*
+ * The result of a fight, filled without printing anything.
+ * winner           - the winning element, NULL for a draw or when there is no opponent
+ * opponent         - the element chosen to fight the challenger (owned by the battle), NULL if none
+ * challengerAttack - the challenger's attack in this fight
+ * opponentAttack   - the opponent's attack in this fight
+ * outcome          - how the fight ended
+ */
+typedef struct FightResult {
+    element winner;
+    element opponent;
+    int challengerAttack;
+    int opponentAttack;
+    fightOutcome outcome;
+} FightResult;
+
 /*
  * Creates a new battle system that stores elements by string categories.
  * Returns NULL on error.
- * capacity           - max number of elements per category
+ * capacity           - max number of elements per category, or UNBOUNDED_CAPACITY for no limit
+ *                      (category storage grows on demand either way)
  * numberOfCategories - number of categories
- * categories         - comma-separated category names, e.g. "cat1,cat2,cat3"
+ * categories         - comma-separated category names, e.g. "cat1,cat2,cat3" (the string is not changed)
  * generic functions  - function pointers as required by the generic ADT
  */
 Battle createBattleByCategory(int capacity,int numberOfCategories,char* categories,equalFunction equalElement,copyFunction copyElement,freeFunction freeElement,getCategoryFunction getCategory,getAttackFunction getAttack,printFunction printElement);
@@ -22,6 +51,17 @@ Battle createBattleByCategory(int capacity,int numberOfCategories,char* categori
  */
 status destroyBattleByCategory(Battle b);
 
+/*
+ * Chooses what happens when an insert reaches a full category (see capacityPolicy in Defs.h).
+ * The default is reject_when_full. Switching to evict_weakest turns the category heaps into
+ * min-max heaps, so the weakest element of a category is found in O(1) and removed in O(log n);
+ * from then on a full category frees its weakest element to make room for a stronger one.
+ * b      - battle pointer
+ * policy - the new policy
+ * Returns success, memory_error if the heaps could not be converted, or failure on bad input.
+ */
+status setCapacityPolicy(Battle b, capacityPolicy policy);
+
 /*
  * Inserts a new element into the correct category, if possible.
  * b    - battle pointer
@@ -30,6 +70,89 @@ status destroyBattleByCategory(Battle b);
  */
 status insertObject(Battle b, element elem);
 
+/*
+ * Returns the interned id of a category: its 0-based position in the categories string
+ * given to createBattleByCategory. Ids can be resolved once and then used with the *ById
+ * functions and with a category id function, which skip the lookup by name.
+ * b        - battle pointer
+ * category - category name
+ * Returns the id, or -1 if the category does not exist or the input is NULL.
+ */
+int getCategoryId(Battle b, char* category);
+
+/*
+ * Makes the battle find the category of an element through its id instead of its name,
+ * in insertObject, insertObjectOwned and insertObjectsBulk. NULL goes back to getCategory.
+ * b             - battle pointer
+ * getCategoryId - function returning an element's category id (see getCategoryId), or NULL
+ * Returns success, or failure if b is NULL.
+ */
+status setCategoryIdFunction(Battle b, getCategoryIdFunction getCategoryId);
+
+/*
+ * Inserts a copy of an element into the category with the given id, like insertObject.
+ * b    - battle pointer
+ * id   - category id (see getCategoryId)
+ * elem - element to insert
+ * Returns success on success, failure for an unknown id, or another error status.
+ */
+status insertObjectById(Battle b, int id, element elem);
+
+/*
+ * Inserts an element into the correct category without copying it.
+ * The battle takes ownership of the element; on any error the caller still owns it.
+ * b    - battle pointer
+ * elem - element to adopt
+ * Returns status_success on success, error status otherwise.
+ */
+status insertObjectOwned(Battle b, element elem);
+
+/*
+ * Inserts a batch of elements, building each category heap once in linear time.
+ * The battle takes ownership of the elements (no copies are made); elements that do not
+ * fit in a full category are freed (under evict_weakest they first try to replace the weakest
+ * elements of their category). The array itself stays owned by the caller.
+ * b     - battle pointer
+ * elems - array of n elements
+ * n     - number of elements
+ * Returns success if all were inserted (under evict_weakest also when they made room by evicting
+ * weaker elements), failure_fullcapacity if some of them were dropped,
+ * or an error status (failure/memory_error) in which case nothing was adopted.
+ */
+status insertObjectsBulk(Battle b, element* elems, int n);
+
+/*
+ * Moves the elements of the given categories from src into the same categories of dst,
+ * in linear time and without copying any element. The merged categories of src are left empty.
+ * Both battles must use the same compare and free functions.
+ * dst        - battle pointer receiving the elements
+ * src        - battle pointer giving them away
+ * categories - comma separated names of the categories to merge
+ * Returns success, failure_fullcapacity if a category would exceed the capacity of dst,
+ * or an error status (failure/memory_error); on any error no category is merged.
+ */
+status mergeCategories(Battle dst, Battle src, char* categories);
+
+/*
+ * Moves all elements of src into the matching categories of dst (see mergeCategories).
+ * Every category of src must also exist in dst. src stays valid and empty and still has to be destroyed.
+ * dst - battle pointer receiving the elements
+ * src - battle pointer giving them away
+ * Returns success, or an error status as in mergeCategories.
+ */
+status mergeBattle(Battle dst, Battle src);
+
+/*
+ * Calls visit once per category, in the order the categories were given, with a user context.
+ * The element passed to visit is the category's MaxHeap (see MaxHeap.h); it stays owned by the battle.
+ * The traversal stops early as soon as visit returns false.
+ * b     - battle pointer
+ * visit - function to call on each category
+ * ctx   - context pointer passed as is to every call, may be NULL
+ * Returns success if the traversal ran, or failure on NULL input.
+ */
+status forEachCategory(Battle b, visitFunction visit, element ctx);
+
 /*
  * Prints all elements grouped by categories, from strongest to weakest.
  * b - battle pointer
@@ -44,6 +167,98 @@ void displayObjectsByCategories(Battle b);
  */
 element removeMaxByCategory(Battle b,char* category);
 
+/*
+ * Removes and returns the strongest element of the category with the given id, like removeMaxByCategory.
+ * b  - battle pointer
+ * id - category id (see getCategoryId)
+ * Returns the element (the caller frees it), or NULL if the id is unknown or the category is empty.
+ */
+element removeMaxById(Battle b, int id);
+
+/*
+ * Removes a specific element from a category in O(n) search + O(log n) removal, without rebuilding the category.
+ * b        - battle pointer
+ * category - category name
+ * key      - key identifying the element (e.g. a name)
+ * match    - returns 0 when an element matches the key
+ * Returns the removed element (the caller frees it), or NULL if none.
+ */
+element removeObjectByKey(Battle b, char* category, element key, equalFunction match);
+
+/*
+ * Changes a specific element of a category in place (e.g. its attack) and restores the category order in O(log n).
+ * b        - battle pointer
+ * category - category name
+ * key      - key identifying the element (e.g. a name)
+ * match    - returns 0 when an element matches the key
+ * update   - changes the element according to arg
+ * arg      - argument passed to update
+ * Returns the status of update, or failure if the element was not found.
+ */
+status updateObjectByKey(Battle b, char* category, element key, equalFunction match, updateFunction update, element arg);
+
+/*
+ * Fills out with the k strongest elements of a category, strongest first, without removing or copying them.
+ * The elements are still managed by the battle and should not be freed by the user.
+ * b        - battle pointer
+ * category - category name
+ * k        - number of elements requested
+ * out      - array with room for at least k elements
+ * Returns the number of elements written, or -1 on error.
+ */
+int topKByCategory(Battle b, char* category, int k, element out[]);
+
+/*
+ * Returns the strongest element of all categories in O(1), without removing it; a tournament over the
+ * category tops is kept up to date in O(log categories) by every change made through this interface.
+ * Between equal elements the one of the lowest category id is chosen.
+ * b - battle pointer
+ * Returns the element (still managed by the battle), or NULL if the battle is empty or NULL.
+ */
+element topOverall(Battle b);
+
+/*
+ * Removes and returns the strongest element of all categories (see topOverall), in O(log n + log categories).
+ * b - battle pointer
+ * Returns the removed element (the caller frees it), or NULL if the battle is empty or NULL.
+ */
+element popOverall(Battle b);
+
+/*
+ * Fills out with the n strongest elements of all categories, strongest first, without removing or copying them,
+ * in O(n (log n + log categories)). The elements are still managed by the battle and should not be freed by the user.
+ * b   - battle pointer
+ * n   - number of elements requested
+ * out - array with room for at least n elements
+ * Returns the number of elements written, or -1 on error.
+ */
+int topNOverall(Battle b, int n, element out[]);
+
+/*
+ * Creates a read-only iterator that visits the elements of all categories from strongest to weakest
+ * (between equal elements, the lower category id first), by merging ordered walks of the category heaps.
+ * Visiting k elements costs O(k (log k + log categories)) and no element is copied, so a page of a global
+ * ranking is read by calling nextInBattleIterator k times on an iterator that is kept between pages.
+ * The battle must not be modified while the iterator is in use.
+ * b - battle pointer
+ * Returns the new iterator, or NULL if b is NULL or memory allocation failed.
+ */
+BattleIterator createBattleIterator(Battle b);
+
+/*
+ * Returns the next strongest element of the iterated battle.
+ * The element is still managed by the battle and should not be freed by the user.
+ * it - iterator pointer
+ * Returns the element, or NULL if all elements were visited, it is NULL or memory allocation failed.
+ */
+element nextInBattleIterator(BattleIterator it);
+
+/*
+ * Destroys an iterator. The iterated battle is not affected.
+ * it - iterator pointer
+ */
+void destroyBattleIterator(BattleIterator it);
+
 /*
  * Returns how many elements exist in a given category.
  * b        - battle pointer
@@ -52,13 +267,206 @@ element removeMaxByCategory(Battle b,char* category);
 int getNumberOfObjectsInCategory(Battle b,char* category);
 
 /*
- * Performs a battle between elem and the best matching element in the system.
+ * Maintains an index over the category tops so that fight finds its opponent in
+ * O(groups * log categories) getAttack calls instead of one per category, with exactly the same result.
+ * Challengers are sorted into classes (category ids, e.g. the category of the challenger's own type), and
+ * for a challenger class every category falls into one of numGroups groups. The index is exact when,
+ * for any challenger, getAttack(candidate, challenger) depends only on the candidate's group and is
+ * non-decreasing in the element order of equalElement (equal elements giving equal results),
+ * e.g. when the groups are the possible type effectiveness relations.
+ * The index follows every change made through this interface; a challenger whose class is outside
+ * 0..categories-1 is fought by scanning all categories.
+ * b               - battle pointer
+ * challengerClass - function returning the class of a challenger
+ * numGroups       - number of groups
+ * group           - function returning the group of a category for a challenger class
+ * ctx             - context pointer passed as is to group, may be NULL
+ * Returns success, memory_error, or failure on bad input or a group out of range.
+ */
+status enableFightIndex(Battle b, getCategoryIdFunction challengerClass, int numGroups, fightGroupFunction group, element ctx);
+
+/*
+ * Remembers fight results by challenger profile, so a profile fought again while no category top changed
+ * is answered in O(1) without calling getAttack. The battle keeps one version counter that moves whenever
+ * any category top changes through this interface, and a cached result only holds for the version it was
+ * computed at, so any new top invalidates every cached result.
+ * The cache is exact when the opponent and both attacks of a fight depend only on the challenger's class
+ * and key, e.g. its type and attack. Slots are direct-mapped, a profile may push out another one.
+ * b               - battle pointer
+ * challengerClass - function returning the class of a challenger
+ * challengerKey   - function returning the key of a challenger within its class
+ * slots           - number of cached results, 0 disables the cache
+ * Returns success, memory_error, or failure on bad input.
+ */
+status enableFightCache(Battle b, getCategoryIdFunction challengerClass, getKeyFunction challengerKey, int slots);
+
+/*
+ * Decides the battle between elem and the best matching element in the system, without printing.
+ * b      - battle pointer
+ * elem   - challenger element (stays owned by the caller)
+ * result - filled with the opponent, both attacks and the outcome (no_opponent if the system is empty)
+ * Returns success, or failure on NULL input.
+ */
+status fightQuery(Battle b, element elem, FightResult* result);
+
+/*
+ * Performs a battle between elem and the best matching element in the system and prints its details
+ * (see fightQuery for the same battle without printing).
  * b    - battle pointer
  * elem - challenger element
- * Returns the winning element, or NULL if no opponent exists.
- * Also prints the battle details.
+ * Returns the winning element (the opponent on a draw), NULL on NULL input,
+ * or (element)-1 if no opponent exists.
  */
 element fight(Battle b,element elem);
 
+/*
+ * Runs fightQuery for many challengers against the current system at once.
+ * The categories are only read during the batch, so the fights of a large batch are spread over worker
+ * threads (one per available core). The threads are started by the first such batch and reused by the
+ * later ones until the battle is destroyed. getAttack must therefore be safe to call concurrently, and the
+ * battle must not be changed, nor given another batch, by another thread meanwhile.
+ * b           - battle pointer
+ * challengers - array of n challenger elements (stay owned by the caller)
+ * n           - number of challengers
+ * results     - array of n results, results[i] is the fight of challengers[i]
+ * Returns success, or failure on bad input.
+ */
+status fightBatch(Battle b, element* challengers, int n, FightResult* results);
+
+/*
+ * Writes the battle to a binary snapshot file: the categories, the caller's meta bytes (e.g. how elements
+ * relate to each other) and the array of every category heap in storage order, each element serialized as
+ * position-independent bytes. The file is replaced only once the new snapshot is complete.
+ * b         - battle pointer
+ * path      - file to write
+ * meta      - bytes stored as is in the snapshot (see getSnapshotMeta), may be NULL if metaSize is 0
+ * metaSize  - number of meta bytes
+ * serialize - writes the bytes of an element
+ * ctx       - context pointer passed as is to serialize, may be NULL
+ * Returns success, memory_error, or failure on bad input, an I/O error or a serialize error.
+ */
+status saveBattleSnapshot(Battle b, char* path, element meta, int metaSize, serializeFunction serialize, element ctx);
+
+/*
+ * Maps a snapshot file written by saveBattleSnapshot into memory and checks that it is complete.
+ * The mapping is private: writing into it (e.g. tokenizing the categories string) never changes the file.
+ * path - file to open
+ * Returns the snapshot, or NULL if the file is missing, not a complete snapshot, or memory allocation failed.
+ */
+BattleSnapshot openBattleSnapshot(char* path);
+
+/*
+ * Returns the comma separated categories of the battle saved in a snapshot, to create a matching battle.
+ * The string lives in the snapshot and is valid until closeBattleSnapshot.
+ * snap - snapshot pointer
+ * Returns the string, or NULL if snap is NULL.
+ */
+char* getSnapshotCategories(BattleSnapshot snap);
+
+/*
+ * Returns the meta bytes saved in a snapshot, valid until closeBattleSnapshot.
+ * snap     - snapshot pointer
+ * metaSize - set to the number of meta bytes, may be NULL
+ * Returns the bytes, or NULL if snap is NULL.
+ */
+element getSnapshotMeta(BattleSnapshot snap, int* metaSize);
+
+/*
+ * Loads the elements of a snapshot into a battle with the same categories, in linear time: every category
+ * adopts its elements in the saved storage order with one build-heap (see heapifyBulk). In an empty heap of
+ * the same kind that order is already a heap, so the build compares but moves nothing; otherwise it reorders
+ * the elements as usual. Elements beyond the capacity of a category are freed.
+ * b           - battle pointer, created with the categories of getSnapshotCategories
+ * snap        - snapshot pointer
+ * deserialize - creates an element from its bytes (which stay owned by the snapshot)
+ * ctx         - context pointer passed as is to deserialize, may be NULL
+ * Returns success, failure_fullcapacity if some elements were dropped, memory_error (nothing loaded),
+ * or failure if the categories differ or the input is NULL.
+ */
+status loadBattleSnapshot(Battle b, BattleSnapshot snap, deserializeFunction deserialize, element ctx);
+
+/*
+ * Unmaps a snapshot. The elements loaded from it are not affected.
+ * snap - snapshot pointer
+ */
+void closeBattleSnapshot(BattleSnapshot snap);
+
+/*
+ * Opens a journal file for appending, creating it if needed. A journal is a write-ahead log of insertions
+ * and removals in a compact binary form: each one is recorded as it is made, so a battle is restored
+ * by loading its base (e.g. a snapshot) and replaying the journal over it. Every journal has a generation
+ * naming its base: a file of another generation, or one that is not a journal, is started anew with the
+ * given generation. A record torn by a crash is cut off.
+ * Records reach the disk in groups, so up to groupSize-1 recorded operations, already made in memory,
+ * are lost if the program dies before their group is committed.
+ * path       - journal file
+ * generation - generation of the records to come
+ * groupSize  - records are written and synced to disk together once this many are pending (group commit),
+ *              1 syncs every record at once
+ * serialize  - writes the bytes of an inserted element
+ * ctx        - context pointer passed as is to serialize, may be NULL
+ * Returns the journal, or NULL on bad input, an I/O error or failed memory allocation.
+ */
+BattleJournal openBattleJournal(char* path, int generation, int groupSize, serializeFunction serialize, element ctx);
+
+/*
+ * Records the insertion of an element, once it was inserted into the battle (the journal does not change it),
+ * so an insertion that failed is never replayed.
+ * j    - journal pointer
+ * elem - the inserted element
+ * Returns success, memory_error, or failure on bad input, a serialize error or an I/O error.
+ * On an error nothing is recorded, and the insertion should be taken back.
+ */
+status journalInsert(BattleJournal j, element elem);
+
+/*
+ * Records the removal of the strongest element of a category (see removeMaxById), before it is removed.
+ * j  - journal pointer
+ * id - category id
+ * Returns success, memory_error, or failure on bad input or an I/O error.
+ * On an error nothing is recorded, and the removal should not be made.
+ */
+status journalRemoveMax(BattleJournal j, int id);
+
+/*
+ * Writes the pending records and syncs the journal to disk.
+ * j - journal pointer
+ * Returns success, or failure on NULL input or an I/O error (the records stay pending, none of them is in the file).
+ */
+status syncBattleJournal(BattleJournal j);
+
+/*
+ * Empties the journal and gives it a new generation, after its records were folded into a new base.
+ * j          - journal pointer
+ * generation - the new generation
+ * Returns success, or failure on NULL input or an I/O error.
+ */
+status resetBattleJournal(BattleJournal j, int generation);
+
+/*
+ * Syncs and closes a journal.
+ * j - journal pointer
+ * Returns success, or failure on NULL input or an I/O error (the journal is closed either way).
+ */
+status closeBattleJournal(BattleJournal j);
+
+/*
+ * Returns the generation of a journal file.
+ * path - journal file
+ * Returns the generation, or -1 if the file is missing or not a journal.
+ */
+int getJournalGeneration(char* path);
+
+/*
+ * Replays the complete records of a journal file over a battle: insertions adopt a new element
+ * (freed if its category is full) and removals free the removed element.
+ * b           - battle pointer
+ * path        - journal file
+ * generation  - only a journal of this generation is replayed, or -1 for any generation
+ * deserialize - creates an inserted element from its bytes
+ * ctx         - context pointer passed as is to deserialize, may be NULL
+ * Returns success (also when there is nothing to replay), memory_error, or failure on bad input or an I/O error.
+ */
+status replayBattleJournal(Battle b, char* path, int generation, deserializeFunction deserialize, element ctx);
 
 #endif /* BATTLEBYCATEGORY_H_ */
@@ -7,8 +7,15 @@ typedef enum e_bool {false, true} bool;
 //Allows functions to distinguish between logical failures, memory issues, and capacity limits.
 typedef enum e_status {success, failure, failure_fullcapacity, memory_error} status;
 
+//Capacity value meaning "no upper limit". Containers created with it grow on demand instead of rejecting inserts.
+#define UNBOUNDED_CAPACITY (-1)
+
+//What a bounded container does when an insert arrives while it is full:
+//reject the new element, or evict its weakest element if the new one is stronger.
+typedef enum e_policy {reject_when_full, evict_weakest} capacityPolicy;
+
 //Auxiliary type. Represents what stage of the data file the system is currently in.
-typedef enum e_flagline {Types_header,type_list,ea,pokemon} flagline;
+typedef enum e_flagline {ea,pokemon} flagline;
 
 //Auxiliary type. Represents whether the input we received from the user is valid.
 typedef enum e_input {valid,invalid,other} input;
@@ -28,6 +35,34 @@ typedef int (*equalFunction)(element,element);
 
 typedef char* (*getCategoryFunction)(element);
 
+//getCategoryIdFunction: Returns the interned category id of an element (see getCategoryId), or -1 if it has none.
+typedef int (*getCategoryIdFunction)(element);
+
+//visitFunction: Called for each element of a traversal together with the caller's context.
+//Returns true to go on to the next element, or false to stop the traversal early.
+typedef bool (*visitFunction)(element elem, element ctx);
+
+//hashFunction: Returns a hash of an element or of a search key. Equal elements/keys must hash to the same value.
+typedef unsigned long (*hashFunction)(element);
+
+//updateFunction: Changes an element in place according to arg (e.g. sets a new attack value).
+typedef status (*updateFunction)(element elem, element arg);
+
+//getKeyFunction: Returns the integer priority key of an element (used by heaps that compare keys instead of elements).
+typedef int (*getKeyFunction)(element);
+
+//fightGroupFunction: Returns the group (0..number of groups-1) that a category falls in when it faces a challenger
+//of the given class. ctx is the context given together with the function.
+typedef int (*fightGroupFunction)(int categoryId, int challengerClass, element ctx);
+
+//serializeFunction: Writes the bytes that represent an element into buffer, if they fit in size bytes.
+//Returns the number of bytes the element needs (call again with a larger buffer when it exceeds size), or -1 on error.
+typedef int (*serializeFunction)(element elem, char* buffer, int size, element ctx);
+
+//deserializeFunction: Creates a new element from the size bytes written by the matching serializeFunction.
+//Returns the element, or NULL on error.
+typedef element (*deserializeFunction)(char* buffer, int size, element ctx);
+
 /* getAttackFunction :Calculates the attack of both elements.
 * Returns (attackFirst - attackSecond) and stores each attack value in the
 given pointers. */
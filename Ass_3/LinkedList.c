@@ -1,7 +1,11 @@
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include "LinkedList.h"
 
+#define INDEX_INITIAL_BUCKETS 8
+#define SKIP_MAX_LEVEL 32
+
 /**
  * Represents a single node in the doubly linked list.
  * Each node stores a generic element and pointers to its neighbors,
@@ -11,8 +15,33 @@ typedef struct Node_s {
     element prim_p;
     struct Node_s* prev;
     struct Node_s* next;
+    struct Node_s* hash_next;
+    unsigned long hash;
+    //Ordered lists only: the node's links on skip list levels 1..level-1 (level 0 is next), NULL for level 1.
+    struct Node_s** up;
+    int level;
 } Node;
 
+/**
+ * A contiguous chunk of nodes handed out by the node pool of a LinkedList.
+ * Slabs are chained so they can all be released when the list is destroyed.
+ */
+typedef struct Slab_s {
+    struct Slab_s* next;
+    Node nodes[];
+} Slab;
+
+/**
+ * A block of an unrolled list: up to block_size elements stored side by side, in list order,
+ * with links to the neighbouring blocks.
+ */
+typedef struct Block_s {
+    struct Block_s* prev;
+    struct Block_s* next;
+    int count;
+    element elems[];
+} Block;
+
 /**
  * Internal structure representing a doubly linked list.
  * It saved pointers to the head and tail nodes for efficient access
@@ -26,40 +55,374 @@ struct LinkedList_T {
     printFunction printfunc;
     equalFunction eqlfunc;
     equalFunction cmpfunc;
+    int size;
+    //Optional hash index (NULL buckets for a plain list): every node is also chained, through hash_next,
+    //in the bucket of its element's hash, so a key is compared only against the nodes that share its bucket.
+    Node** buckets;
+    int num_buckets;
+    hashFunction keyhash;
+    hashFunction elemhash;
+    //Optional node pool (slab_nodes==0 for malloc per node): nodes are carved from slabs of slab_nodes nodes,
+    //deleted nodes wait on free_nodes (chained through next) for the next append.
+    Slab* slabs;
+    Node* free_nodes;
+    int slab_nodes;
+    //Unrolled engine (block_size==0 for the node engine): the elements live in the arrays of a chain of blocks
+    //and head/tail stay NULL.
+    Block* first_block;
+    Block* last_block;
+    int block_size;
+    //Ordered mode: the nodes stay sorted by cmpfunc and form a skip list. skip_head[l] is the first node
+    //on level l (skip_head[0] is unused, head plays its part) and levels is the number of levels in use.
+    bool ordered;
+    int levels;
+    Node* skip_head[SKIP_MAX_LEVEL];
+    unsigned long seed;
 };
 
 /**
  * Auxiliary function for internal use only.
- * Creates a new node for the linked list and performs a deep copy of the given element.
- * This function allocates memory for a Node structure, invokes the provided copy
- * function to duplicate the generic element, and initializes the node's pointers to NULL.
- * @param elem The generic element to be stored in the node.
- * @param copy_function A pointer to a function that creates a deep copy of the element.
- * @return A pointer to the newly created Node, or NULL if memory allocation fails,
- * if the element is NULL, or if the copy function fails.
- */
-static Node* createNode(element elem,copyFunction copy_function) {
+ * Takes a node from the list's pool, allocating a new slab when no free node is left.
+ * @param l_list A pointer to a pooled LinkedList.
+ * @return A pointer to an uninitialized Node, or NULL if memory allocation fails.
+ */
+static Node* pool_alloc(LinkedList l_list) {
+    if (!l_list->free_nodes) {
+        Slab* slab=(Slab*)malloc(sizeof(Slab)+sizeof(Node)*l_list->slab_nodes);
+        if (!slab) {return NULL;}
+        slab->next=l_list->slabs;
+        l_list->slabs=slab;
+
+        //Chaining the new nodes in address order, so consecutive appends get neighbouring nodes
+        for (int i=l_list->slab_nodes-1; i>=0; i--) {
+            slab->nodes[i].next=l_list->free_nodes;
+            l_list->free_nodes=&slab->nodes[i];
+        }
+    }
+    Node* temp=l_list->free_nodes;
+    l_list->free_nodes=temp->next;
+    return temp;
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Releases a node: back to the pool's free list if the list is pooled, otherwise to the allocator.
+ * @param l_list A pointer to the LinkedList that owned the node.
+ * @param node The node to release, its element must already be released.
+ */
+static void release_node(LinkedList l_list, Node* node) {
+    free(node->up);
+    if (l_list->slab_nodes==0) {
+        free(node);
+        return;
+    }
+    node->next=l_list->free_nodes;
+    l_list->free_nodes=node;
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Frees every node slab of the list and empties its free list.
+ * @param l_list A pointer to the LinkedList.
+ */
+static void free_slabs(LinkedList l_list) {
+    while (l_list->slabs) {
+        Slab* next=l_list->slabs->next;
+        free(l_list->slabs);
+        l_list->slabs=next;
+    }
+    l_list->free_nodes=NULL;
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Frees the list structure itself together with its index and node slabs.
+ * @param l_list A pointer to the LinkedList.
+ */
+static void free_list_struct(LinkedList l_list) {
+    free_slabs(l_list);
+    free(l_list->buckets);
+    free(l_list);
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Creates a new node for the linked list that holds the given element as is.
+ * This function allocates memory for a Node structure (from the list's pool if it has one)
+ * and initializes the node's pointers to NULL.
+ * @param l_list A pointer to the LinkedList the node is for.
+ * @param elem The generic element to be stored in the node, the node takes ownership of it.
+ * @return A pointer to the newly created Node, or NULL if memory allocation fails
+ * or if the element is NULL.
+ */
+static Node* createNode(LinkedList l_list, element elem) {
     //Input validation
     if (!elem) {return NULL;}
 
     //Allocate memory for the current cell
-    Node* temp=malloc(sizeof(Node));
+    Node* temp=l_list->slab_nodes>0 ? pool_alloc(l_list) : malloc(sizeof(Node));
     if (!temp) {return NULL;}
 
-    //Updating the fields of the cell we just created
-    element new_elem=copy_function(elem);
-    if (!new_elem) {
-        free(temp);
-        return NULL;
-    }
-
     //Initializing the relevant fields
-    temp->prim_p=new_elem;
+    temp->prim_p=elem;
     temp->prev=NULL;
     temp->next=NULL;
+    temp->hash_next=NULL;
+    temp->hash=0;
+    temp->up=NULL;
+    temp->level=1;
     return temp;
 }
 
+/**
+ * Auxiliary function for internal use only.
+ * Doubles the number of buckets of the hash index and re-chains every node.
+ * If the allocation fails the index keeps its current buckets, it only gets slower.
+ * @param l_list A pointer to an indexed LinkedList.
+ */
+static void grow_index(LinkedList l_list) {
+    int num=l_list->num_buckets*2;
+    Node** buckets=(Node**)calloc(num,sizeof(Node*));
+    if (!buckets) {return;}
+
+    for (Node* temp=l_list->head; temp!=NULL; temp=temp->next) {
+        int b=(int)(temp->hash%(unsigned long)num);
+        temp->hash_next=buckets[b];
+        buckets[b]=temp;
+    }
+    free(l_list->buckets);
+    l_list->buckets=buckets;
+    l_list->num_buckets=num;
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Finds the node whose element matches a key, through the hash index if the list has one.
+ * @param l_list A pointer to the LinkedList.
+ * @param key The key to compare with the list's equality function.
+ * @return The matching node, or NULL if there is none.
+ */
+static Node* find_node(LinkedList l_list, element key) {
+    if (l_list->buckets) {
+        unsigned long h=l_list->keyhash(key);
+        for (Node* temp=l_list->buckets[h%(unsigned long)l_list->num_buckets]; temp!=NULL; temp=temp->hash_next) {
+            if (temp->hash==h && l_list->eqlfunc(temp->prim_p,key)==0) {return temp;}
+        }
+        return NULL;
+    }
+
+    //Holding a temporary pointer with which we will iterate over all the elements in the list.
+    Node* temp=l_list->head;
+    while (temp!=NULL) {
+        //Compares the value in the current cell to the requested value and returns it if there is a match.
+        if (temp->prim_p!=NULL && l_list->eqlfunc(temp->prim_p,key)==0) {
+            return temp;
+        }
+        //Move to the next element in the linked list
+        temp=temp->next;
+    }
+    //No element was found that met the search criteria.
+    return NULL;
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Adds an element after the last element of an unrolled list, opening a new block when the last one is full.
+ * @param l_list A pointer to an unrolled LinkedList.
+ * @param elem The element to store, the list takes ownership of it.
+ * @return success, or memory_error if a new block could not be allocated.
+ */
+static status unrolled_append(LinkedList l_list, element elem) {
+    Block* last=l_list->last_block;
+    if (!last || last->count==l_list->block_size) {
+        Block* block=(Block*)malloc(sizeof(Block)+sizeof(element)*l_list->block_size);
+        if (!block) {return memory_error;}
+        block->count=0;
+        block->next=NULL;
+        block->prev=last;
+        if (last) {last->next=block;}
+        else {l_list->first_block=block;}
+        l_list->last_block=block;
+        last=block;
+    }
+    last->elems[last->count]=elem;
+    last->count++;
+    l_list->size++;
+    return success;
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Finds the first element of an unrolled list that matches a key.
+ * @param l_list A pointer to an unrolled LinkedList.
+ * @param key The key to compare with the list's equality function.
+ * @param pos Output: the index of the element inside the returned block.
+ * @return The block holding the matching element, or NULL if there is none.
+ */
+static Block* unrolled_find(LinkedList l_list, element key, int* pos) {
+    for (Block* block=l_list->first_block; block!=NULL; block=block->next) {
+        for (int i=0; i<block->count; i++) {
+            if (l_list->eqlfunc(block->elems[i],key)==0) {
+                *pos=i;
+                return block;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Removes (without freeing) the element at a position of a block, keeping the order of the others.
+ * An emptied block is released, and a block that can take in its successor absorbs it,
+ * so blocks stay at least half full on average.
+ * @param l_list A pointer to an unrolled LinkedList.
+ * @param block The block holding the element.
+ * @param pos The index of the element inside the block.
+ */
+static void unrolled_remove_at(LinkedList l_list, Block* block, int pos) {
+    memmove(block->elems+pos,block->elems+pos+1,sizeof(element)*(block->count-pos-1));
+    block->count--;
+    l_list->size--;
+
+    //An empty block is unlinked and freed
+    if (block->count==0) {
+        if (block->prev) {block->prev->next=block->next;}
+        else {l_list->first_block=block->next;}
+        if (block->next) {block->next->prev=block->prev;}
+        else {l_list->last_block=block->prev;}
+        free(block);
+        return;
+    }
+
+    //Merging with the next block when both fit in one
+    Block* next=block->next;
+    if (next && block->count+next->count<=l_list->block_size) {
+        memcpy(block->elems+block->count,next->elems,sizeof(element)*next->count);
+        block->count+=next->count;
+        block->next=next->next;
+        if (next->next) {next->next->prev=block;}
+        else {l_list->last_block=block;}
+        free(next);
+    }
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Returns the successor of a node on a skip list level.
+ * @param l_list A pointer to an ordered LinkedList.
+ * @param node The node, or NULL for the front of the list.
+ * @param lvl The level, below the node's level.
+ * @return The next node on that level, or NULL at the end.
+ */
+static Node* skip_next(LinkedList l_list, Node* node, int lvl) {
+    if (lvl==0) {return node ? node->next : l_list->head;}
+    return node ? node->up[lvl-1] : l_list->skip_head[lvl];
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Sets the successor of a node on a skip list level (level 0 sets next, or head for the front).
+ * @param l_list A pointer to an ordered LinkedList.
+ * @param node The node, or NULL for the front of the list.
+ * @param lvl The level, below the node's level.
+ * @param next The new successor.
+ */
+static void skip_set_next(LinkedList l_list, Node* node, int lvl, Node* next) {
+    if (lvl==0) {
+        if (node) {node->next=next;}
+        else {l_list->head=next;}
+        return;
+    }
+    if (node) {node->up[lvl-1]=next;}
+    else {l_list->skip_head[lvl]=next;}
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Walks down the skip list to the first node that is not before key (lower bound), or, with
+ * after_equal, to the first node after key (upper bound), recording the last node before it on every level.
+ * @param l_list A pointer to an ordered LinkedList.
+ * @param key The key, compared through cmpfunc(stored element, key).
+ * @param preds Output (may be NULL): for each level in use, the last node before the result, or NULL for the front.
+ * @param after_equal Whether nodes equal to key are passed over.
+ * @return The node found, or NULL if every node is before it.
+ */
+static Node* skip_seek(LinkedList l_list, element key, Node** preds, bool after_equal) {
+    Node* node=NULL;
+    for (int lvl=l_list->levels-1; lvl>=0; lvl--) {
+        Node* next=skip_next(l_list,node,lvl);
+        while (next!=NULL) {
+            int cmp=l_list->cmpfunc(next->prim_p,key);
+            if (cmp!=-1 && !(after_equal && cmp==0)) {break;}
+            node=next;
+            next=skip_next(l_list,node,lvl);
+        }
+        if (preds) {preds[lvl]=node;}
+    }
+    return skip_next(l_list,node,0);
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Links a new node into an ordered list after all the nodes that are not after it,
+ * on a random number of levels (each further level with probability 1/2).
+ * @param l_list A pointer to an ordered LinkedList.
+ * @param node The new node, not linked anywhere yet.
+ * @return success, or memory_error if the node's level links could not be allocated.
+ */
+static status skip_insert(LinkedList l_list, Node* node) {
+    int level=1;
+    while (level<SKIP_MAX_LEVEL) {
+        //xorshift, the list keeps its own generator so it does not disturb rand()
+        l_list->seed^=l_list->seed<<13;
+        l_list->seed^=l_list->seed>>7;
+        l_list->seed^=l_list->seed<<17;
+        if (!(l_list->seed&1UL)) {break;}
+        level++;
+    }
+    if (level>1) {
+        node->up=(Node**)malloc(sizeof(Node*)*(level-1));
+        if (!node->up) {return memory_error;}
+    }
+    node->level=level;
+
+    Node* preds[SKIP_MAX_LEVEL];
+    skip_seek(l_list,node->prim_p,preds,true);
+    for (int lvl=l_list->levels; lvl<level; lvl++) {preds[lvl]=NULL;}
+    if (level>l_list->levels) {l_list->levels=level;}
+
+    for (int lvl=0; lvl<level; lvl++) {
+        skip_set_next(l_list,node,lvl,skip_next(l_list,preds[lvl],lvl));
+        skip_set_next(l_list,preds[lvl],lvl,node);
+    }
+    node->prev=preds[0];
+    if (node->next) {node->next->prev=node;}
+    else {l_list->tail=node;}
+    return success;
+}
+
+/**
+ * Auxiliary function for internal use only.
+ * Finds the first node of an ordered list that matches key and unlinks it from the levels above level 0,
+ * the caller unlinks it from the level 0 chain (head/tail/prev/next) like any other node.
+ * @param l_list A pointer to an ordered LinkedList.
+ * @param key The key, compared through cmpfunc(stored element, key).
+ * @return The matching node, or NULL if there is none.
+ */
+static Node* skip_detach(LinkedList l_list, element key) {
+    Node* preds[SKIP_MAX_LEVEL];
+    Node* node=skip_seek(l_list,key,preds,false);
+    if (!node || l_list->cmpfunc(node->prim_p,key)!=0) {return NULL;}
+
+    //The node is the first one not before key, so on each of its levels it follows preds directly
+    for (int lvl=1; lvl<node->level; lvl++) {
+        skip_set_next(l_list,preds[lvl],lvl,node->up[lvl-1]);
+    }
+    while (l_list->levels>1 && l_list->skip_head[l_list->levels-1]==NULL) {l_list->levels--;}
+    return node;
+}
+
 LinkedList createLinkedList(copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc , equalFunction cmpFunc) {
     //input validation
     if (!copyFunc || !freeFunc || !printFunc || !eqlFunc || !cmpFunc) {return NULL; }
@@ -78,16 +441,89 @@ LinkedList createLinkedList(copyFunction copyFunc, freeFunction freeFunc, printF
     l_list->printfunc=printFunc;
     l_list->eqlfunc=eqlFunc;
     l_list->cmpfunc=cmpFunc;
+    l_list->size=0;
+    l_list->buckets=NULL;
+    l_list->num_buckets=0;
+    l_list->keyhash=NULL;
+    l_list->elemhash=NULL;
+    l_list->slabs=NULL;
+    l_list->free_nodes=NULL;
+    l_list->slab_nodes=0;
+    l_list->first_block=NULL;
+    l_list->last_block=NULL;
+    l_list->block_size=0;
+    l_list->ordered=false;
+    l_list->levels=1;
+    for (int i=0; i<SKIP_MAX_LEVEL; i++) {l_list->skip_head[i]=NULL;}
+    l_list->seed=0x2545F491UL;
+    return l_list;
+}
+
+LinkedList createOrderedLinkedList(copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc, equalFunction cmpFunc) {
+    LinkedList l_list=createLinkedList(copyFunc,freeFunc,printFunc,eqlFunc,cmpFunc);
+    if (!l_list) {return NULL;}
+    l_list->ordered=true;
+    return l_list;
+}
+
+LinkedList createUnrolledLinkedList(copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc, equalFunction cmpFunc, int blockSize) {
+    //input validation
+    if (blockSize<=0) {return NULL;}
+
+    LinkedList l_list=createLinkedList(copyFunc,freeFunc,printFunc,eqlFunc,cmpFunc);
+    if (!l_list) {return NULL;}
+    l_list->block_size=blockSize;
+    return l_list;
+}
+
+LinkedList createIndexedLinkedList(copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc, equalFunction cmpFunc, hashFunction keyHash, hashFunction elemHash) {
+    //input validation
+    if (!keyHash || !elemHash) {return NULL;}
+
+    LinkedList l_list=createLinkedList(copyFunc,freeFunc,printFunc,eqlFunc,cmpFunc);
+    if (!l_list) {return NULL;}
+
+    //Allocating the buckets of the index
+    l_list->buckets=(Node**)calloc(INDEX_INITIAL_BUCKETS,sizeof(Node*));
+    if (!l_list->buckets) {
+        free(l_list);
+        return NULL;
+    }
+    l_list->num_buckets=INDEX_INITIAL_BUCKETS;
+    l_list->keyhash=keyHash;
+    l_list->elemhash=elemHash;
     return l_list;
 }
 
+status setNodePool(LinkedList l_list, int slabNodes) {
+    //input validation, the allocation scheme can only change while no node exists
+    if (!l_list || slabNodes<0 || l_list->head!=NULL || l_list->block_size>0) {return failure;}
+
+    //Dropping the slabs of a previous pool, all their nodes are free
+    free_slabs(l_list);
+    l_list->slab_nodes=slabNodes;
+    return success;
+}
+
 status destroyLinkedList(LinkedList l_list) {
     //validate arguments
     if (!l_list) { return failure;}
 
+    //unrolled list, every block is freed after its elements
+    while (l_list->first_block!=NULL) {
+        Block* block=l_list->first_block;
+        for (int i=0; i<block->count; i++) {
+            if (l_list->freefunc(block->elems[i])==failure) {
+                return failure;
+            }
+        }
+        l_list->first_block=block->next;
+        free(block);
+    }
+
     //empty list,
     if (l_list->head==NULL) {
-        free(l_list);
+        free_list_struct(l_list);
         return success;
     }
 
@@ -102,15 +538,16 @@ status destroyLinkedList(LinkedList l_list) {
             return failure;
         }
 
-        //free of the current Node
-        free(temp);
+        //free of the current Node, pooled nodes go away with their slabs
+        free(temp->up);
+        if (l_list->slab_nodes==0) {free(temp);}
 
         //Promote the temp pointer to the next node
         temp=next;
     }
 
     //free the linked list itself
-    free(l_list);
+    free_list_struct(l_list);
     return success;
 }
 
@@ -118,21 +555,60 @@ status appendNode(LinkedList l_list, element elem){
     //input validation
     if (!l_list || !elem) {return failure;}
 
+    //deep copy of the element, the list owns the copy
+    element new_elem=l_list->copyfunc(elem);
+    if (!new_elem) {return memory_error;}
+
+    status st=appendNodeOwned(l_list,new_elem);
+    if (st!=success) {l_list->freefunc(new_elem);}
+    return st;
+}
+
+status appendNodeOwned(LinkedList l_list, element elem){
+    //input validation
+    if (!l_list || !elem) {return failure;}
+
+    //unrolled list, the element goes into the last block
+    if (l_list->block_size>0) {return unrolled_append(l_list,elem);}
+
     //create new Node struct
-    Node* temp=createNode(elem,l_list->copyfunc);
+    Node* temp=createNode(l_list,elem);
     if (!temp) {return memory_error;}
 
+    //ordered list, the node goes to its sorted place
+    if (l_list->ordered) {
+        if (skip_insert(l_list,temp)!=success) {
+            release_node(l_list,temp);
+            return memory_error;
+        }
+        l_list->size++;
+        return success;
+    }
+
+    //chaining the node in the bucket of its hash
+    if (l_list->buckets) {
+        temp->hash=l_list->elemhash(elem);
+        int b=(int)(temp->hash%(unsigned long)l_list->num_buckets);
+        temp->hash_next=l_list->buckets[b];
+        l_list->buckets[b]=temp;
+    }
+    l_list->size++;
+
     //case analysis
     //first element added
     if (l_list->head==NULL) {
         l_list->head=temp;
         l_list->tail=temp;
-        return success;
     }
     //l_list contain at least 1 element
-    l_list->tail->next=temp;
-    temp->prev=l_list->tail;
-    l_list->tail=temp;
+    else {
+        l_list->tail->next=temp;
+        temp->prev=l_list->tail;
+        l_list->tail=temp;
+    }
+
+    //the index grows once it holds more nodes than buckets
+    if (l_list->buckets && l_list->size>l_list->num_buckets) {grow_index(l_list);}
     return success;
 }
 
@@ -140,47 +616,70 @@ status deleteNode(LinkedList l_list, element elem) {
     //input validation
     if (!l_list || !elem) {return failure;}
 
-    //iterate over all the nodes to find the relevant one.
-    Node* temp=l_list->head;
-    while (temp!=NULL) {
-        if (temp->prim_p!=NULL && l_list->eqlfunc(temp->prim_p,elem)==0) {
+    //unrolled list, the element is taken out of its block
+    if (l_list->block_size>0) {
+        int pos;
+        Block* block=unrolled_find(l_list,elem,&pos);
+        if (!block) {return failure;}
+        element found=block->elems[pos];
+        unrolled_remove_at(l_list,block,pos);
+        l_list->freefunc(found);
+        return success;
+    }
 
-            //only one object in the linked_list
-            if (temp==l_list->head && temp==l_list->tail ){l_list->head=NULL;l_list->tail=NULL;}
+    //finding the relevant node, through the index or the skip list when there is one
+    Node* temp=l_list->ordered ? skip_detach(l_list,elem) : find_node(l_list,elem);
 
-            //headcase
-            else if (temp==l_list->head && temp!=l_list->tail ) {
-                l_list->head=l_list->head->next;
-                temp->next->prev=NULL;
-            }
+    //All links in the linked list were traversed and the requested element was not found.
+    if (!temp) {return failure;}
 
-            //tailcase
-            else if (temp!=l_list->head && temp==l_list->tail) {
-                l_list->tail=l_list->tail->prev;
-                temp->prev->next=NULL;
-            }
+    //unchaining the node from its index bucket
+    if (l_list->buckets) {
+        Node** link=&l_list->buckets[temp->hash%(unsigned long)l_list->num_buckets];
+        while (*link!=temp) {link=&(*link)->hash_next;}
+        *link=temp->hash_next;
+    }
 
-            //middlecase
-            else {
-                temp->prev->next=temp->next;
-                temp->next->prev=temp->prev;
-            }
-            //in all cases free Node
-            l_list->freefunc(temp->prim_p);
-            free(temp);
-            return success;
-        }
-        //Move to the next element in the linked list
-        temp=temp->next;
+    //only one object in the linked_list
+    if (temp==l_list->head && temp==l_list->tail ){l_list->head=NULL;l_list->tail=NULL;}
+
+    //headcase
+    else if (temp==l_list->head && temp!=l_list->tail ) {
+        l_list->head=l_list->head->next;
+        temp->next->prev=NULL;
     }
-    //All links in the linked list were traversed and the requested element was not found.
-    return failure;
+
+    //tailcase
+    else if (temp!=l_list->head && temp==l_list->tail) {
+        l_list->tail=l_list->tail->prev;
+        temp->prev->next=NULL;
+    }
+
+    //middlecase
+    else {
+        temp->prev->next=temp->next;
+        temp->next->prev=temp->prev;
+    }
+    //in all cases free Node
+    l_list->size--;
+    l_list->freefunc(temp->prim_p);
+    release_node(l_list,temp);
+    return success;
 }
 
 status printLinkedList(LinkedList l_list) {
     //input validation
     if (!l_list) {return failure;}
 
+    //unrolled list, each block is printed from its array
+    for (Block* block=l_list->first_block; block!=NULL; block=block->next) {
+        for (int i=0; i<block->count; i++) {
+            if (l_list->printfunc(block->elems[i])==failure) {
+                return failure;
+            }
+        }
+    }
+
     //Holding a temporary pointer with which we will iterate over all the elements in the list.
     Node* temp=l_list->head;
     while (temp!=NULL) {
@@ -198,17 +697,48 @@ element searchByKeyInList(LinkedList l_list, element key) {
     //input validation
     if (!l_list || !key) {return NULL;}
 
-    //Holding a temporary pointer with which we will iterate over all the elements in the list.
-    Node* temp=l_list->head;
+    //unrolled list, scanning the block arrays
+    if (l_list->block_size>0) {
+        int pos;
+        Block* block=unrolled_find(l_list,key,&pos);
+        return block ? block->elems[pos] : NULL;
+    }
 
-    while (temp!=NULL) {
-        //Compares the value in the current cell to the requested value and returns it if there is a match.
-        if (temp->prim_p!=NULL && l_list->eqlfunc(temp->prim_p,key)==0) {
-            return temp->prim_p;
+    //ordered list, descending the skip list
+    if (l_list->ordered) {
+        Node* temp=skip_seek(l_list,key,NULL,false);
+        return temp && l_list->cmpfunc(temp->prim_p,key)==0 ? temp->prim_p : NULL;
+    }
+
+    Node* temp=find_node(l_list,key);
+    return temp ? temp->prim_p : NULL;
+}
+
+status forEachInList(LinkedList l_list, visitFunction visit, element ctx) {
+    //input validation
+    if (!l_list || !visit) {return failure;}
+
+    //unrolled list, walking the block arrays
+    for (Block* block=l_list->first_block; block!=NULL; block=block->next) {
+        for (int i=0; i<block->count; i++) {
+            if (!visit(block->elems[i],ctx)) {return success;}
         }
-        //Move to the next element in the linked list
-        temp=temp->next;
     }
-    //No element was found that met the search criteria.
-    return NULL;
+
+    //Walking the nodes in list order until the callback asks to stop
+    for (Node* temp=l_list->head; temp!=NULL; temp=temp->next) {
+        if (!visit(temp->prim_p,ctx)) {return success;}
+    }
+    return success;
+}
+
+status forEachFromKey(LinkedList l_list, element key, visitFunction visit, element ctx) {
+    //input validation
+    if (!l_list || !key || !visit || !l_list->ordered) {return failure;}
+
+    //Starting at the lower bound and walking the bottom level in order until the callback asks to stop
+    for (Node* temp=skip_seek(l_list,key,NULL,false); temp!=NULL; temp=temp->next) {
+        if (!visit(temp->prim_p,ctx)) {return success;}
+    }
+    return success;
 }
\ No newline at end of file
@@ -19,6 +19,49 @@ typedef struct LinkedList_T* LinkedList;
  */
 LinkedList createLinkedList(copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc, equalFunction cmpFunc);
 
+/**
+ * Creates a LinkedList with a hash index, so searchByKeyInList and deleteNode take O(1) on average
+ * instead of comparing the key with every element. The index is kept in sync on append and delete.
+ * The other parameters are as in createLinkedList.
+ * @param keyHash Function to hash a search key (the value given to searchByKeyInList/deleteNode).
+ * @param elemHash Function to hash a stored element, equal to keyHash of the keys that match it.
+ * If several elements match the same key, which of them is found is unspecified.
+ * @return A pointer to the new LinkedList, or NULL if any input is NULL or allocation failed.
+ */
+LinkedList createIndexedLinkedList(copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc, equalFunction cmpFunc, hashFunction keyHash, hashFunction elemHash);
+
+/**
+ * Creates a LinkedList backed by an unrolled list: blocks that each hold up to blockSize elements
+ * side by side, linked to their neighbours. Scans (searchByKeyInList, printLinkedList) then read
+ * consecutive memory instead of following one pointer per element. Append order and deleteNode
+ * behave exactly as in a list made by createLinkedList. The other parameters are as in createLinkedList.
+ * @param blockSize The maximal number of elements in a block (e.g. 16).
+ * @return A pointer to the new LinkedList, or NULL if any input is invalid or allocation failed.
+ */
+LinkedList createUnrolledLinkedList(copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc, equalFunction cmpFunc, int blockSize);
+
+/**
+ * Creates a LinkedList that keeps its elements sorted in ascending cmpFunc order, backed by a skip list.
+ * appendNode and appendNodeOwned insert at the sorted place (after equal elements) in O(log n) on average,
+ * and searchByKeyInList, deleteNode and forEachFromKey find keys in O(log n) on average.
+ * In this mode keys are compared through cmpFunc(stored element, key) instead of eqlFunc, so cmpFunc
+ * must accept a search key (or a probe element) as its second argument.
+ * The parameters are as in createLinkedList.
+ * @return A pointer to the new LinkedList, or NULL if any input is NULL or allocation failed.
+ */
+LinkedList createOrderedLinkedList(copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc, equalFunction cmpFunc);
+
+/**
+ * Makes the list allocate its nodes from a pool: contiguous slabs of slabNodes nodes each.
+ * Deleted nodes are kept on a free list and reused by later appends, and all slabs are
+ * released at once by destroyLinkedList. A slabNodes of 0 goes back to one allocation per node.
+ * The pool can only be set while the list is empty.
+ * @param l_list A pointer to the LinkedList.
+ * @param slabNodes The number of nodes in each slab, or 0 for no pool.
+ * @return success if the pool was set, or failure if the list is NULL, not empty, unrolled or slabNodes is negative.
+ */
+status setNodePool(LinkedList l_list, int slabNodes);
+
 /**
  * Destroys a linked list and deallocates all associated memory.
  * The function iterates through the list, invoking the specific free function
@@ -41,6 +84,17 @@ status destroyLinkedList(LinkedList l_list);
  */
 status appendNode(LinkedList l_list, element elem);
 
+/**
+ * Adds an element to the end of the linked list without copying it.
+ * The list takes ownership of the element and will free it on delete or destroy.
+ * @param l_list A pointer to the LinkedList where the element will be added.
+ * @param elem The element to be adopted by the list.
+ * @return status success if the element was added, memory_error if memory allocation
+ * for the new node fails, or failure if the list or element pointers are NULL.
+ * On any error the caller still owns the element.
+ */
+status appendNodeOwned(LinkedList l_list, element elem);
+
 /**
  * Removes a specific element from the doubly linked list if it exists.
  * The function searches for a node containing an element equal to the provided one
@@ -72,4 +126,28 @@ status printLinkedList(LinkedList l_list);
  * or NULL if the element does not exist or if the input pointers are invalid.
  */
 element searchByKeyInList(LinkedList l_list, element key);
+
+/**
+ * Calls a function on every element of the list, in list order, with a user context.
+ * The traversal stops early as soon as the function returns false.
+ * Elements are passed as stored in the list and must not be freed or removed by the function.
+ * @param l_list A pointer to the LinkedList.
+ * @param visit The function to call on each element.
+ * @param ctx A context pointer passed as is to every call, may be NULL.
+ * @return success if the traversal ran (to the end or stopped by visit),
+ * or failure if the list or function pointers are NULL.
+ */
+status forEachInList(LinkedList l_list, visitFunction visit, element ctx);
+
+/**
+ * Range scan of an ordered list (createOrderedLinkedList): calls visit on every element that is not
+ * before key, in ascending order, starting at the first of them (lower bound).
+ * The traversal stops early as soon as visit returns false, e.g. at the end of the wanted range.
+ * @param l_list A pointer to an ordered LinkedList.
+ * @param key The key where the range starts, compared through cmpFunc(stored element, key).
+ * @param visit The function to call on each element.
+ * @param ctx A context pointer passed as is to every call, may be NULL.
+ * @return success if the traversal ran, or failure if an input is NULL or the list is not ordered.
+ */
+status forEachFromKey(LinkedList l_list, element key, visitFunction visit, element ctx);
 #endif //ASS_3_LINKEDLIST_H
\ No newline at end of file
@@ -4,15 +4,69 @@
 #include <stdio.h>
 #include "MaxHeap.h"
 
+//Number of slots allocated when a heap is created, before any growth.
+#define HEAP_INITIAL_SLOTS 4
+
+//Largest key range a bucket heap accepts, one bucket per key.
+#define HEAP_MAX_BUCKETS (1<<24)
+
+//Arity used by createHeap. Can be overridden at compile time, e.g. -DHEAP_DEFAULT_ARITY=4
+#ifndef HEAP_DEFAULT_ARITY
+#define HEAP_DEFAULT_ARITY 2
+#endif
+#if HEAP_DEFAULT_ARITY!=2 && HEAP_DEFAULT_ARITY!=4 && HEAP_DEFAULT_ARITY!=8
+#error "HEAP_DEFAULT_ARITY must be 2, 4 or 8"
+#endif
+
+//Compiling with -DHEAP_PREFETCH asks the CPU to fetch the next child block while the current one is compared.
+#if defined(HEAP_PREFETCH) && defined(__GNUC__)
+#define PREFETCH_SLOT(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH_SLOT(addr) ((void)0)
+#endif
+
+//The storage engines a MaxHeap can be created with.
+typedef enum e_heapKind {pointer_heap, inline_heap, bucket_heap, minmax_heap} heapKind;
+
 /**
  * Represents a generic Max-Heap data structure.
  * The heap is implemented using a dynamic array and stores elements
  * of any type, maintaining the Max-Heap rules where the largest
  * element is always at the root.
+ * MaxSize is the insert limit (UNBOUNDED_CAPACITY for none) while allocated
+ * is the number of slots the array currently has, which grows geometrically.
+ * Each node has up to 'arity' children, stored at arity*i+1 .. arity*i+arity.
+ * An inline heap keeps fixed-size records by value in 'records' instead of
+ * pointers in 'array', with each record's key in the parallel 'keys' array, so comparisons
+ * only read the contiguous keys. 'scratch' holds the record being moved during a sift.
+ * An indexed heap also keeps heap_handle (position -> handle) and handle_pos (handle -> position),
+ * two inverse permutations of 0..handle_slots-1. The handles found at positions >= capacity are the free ones.
+ * A bucket heap is a bucket queue over the integer keys min_key..min_key+num_buckets-1: 'array' holds the
+ * element slots, bucket_head[k] starts the chain (through slot_next) of the elements whose key is min_key+k,
+ * unused slots are chained from free_slot and top_bucket is the highest non-empty bucket.
+ * A min-max heap is a binary pointer heap whose even levels (the root's level) are max levels, holding the
+ * largest element of their subtree, and whose odd levels are min levels, holding the smallest one.
  */
 struct MaxHeap_s {
+    heapKind kind;
     element* array;
+    int* bucket_head;
+    int* slot_next;
+    int min_key;
+    int num_buckets;
+    int top_bucket;
+    int free_slot;
+    int* heap_handle;
+    int* handle_pos;
+    int handle_slots;
+    char* records;
+    int* keys;
+    char* scratch;
+    int rec_size;
+    getKeyFunction getkeyfunc;
+    int arity;
     int MaxSize;
+    int allocated;
     int capacity;
     char* h_name;
     copyFunction copyfunc;
@@ -21,9 +75,213 @@ struct MaxHeap_s {
     equalFunction eqlfunc;
 };
 
+/**
+ * Read-only ordered cursor over a MaxHeap.
+ * The frontier is a small max-heap of indices into the heap's array holding the
+ * candidates for the next largest element, so no element is ever copied.
+ */
+struct HeapIterator_s {
+    MaxHeap heap;
+    int* frontier;
+    int size;
+    int slots;
+    int bucket;
+    int slot;
+};
+
+/**
+ * Auxiliary function for self use only.
+ * Returns the element stored at a position: the pointer itself, or the address of an inline record.
+ * @param heap A pointer to the MaxHeap structure.
+ * @param i The position in the heap.
+ * @return The element at position i.
+ */
+static element slot_elem(MaxHeap heap, int i) {
+    if (heap->kind==inline_heap) {return heap->records+(size_t)i*heap->rec_size;}
+    return heap->array[i];
+}
+
 /**
  * Auxiliary function for self use only.
- * Maintains the Max-Heap property by recursively move down an element.
+ * Checks whether the element at position i is larger than the element at position j.
+ * @param heap A pointer to the MaxHeap structure.
+ * @return 1 if the element at i is larger, otherwise 0.
+ */
+static int slot_greater(MaxHeap heap, int i, int j) {
+    if (heap->kind==inline_heap) {return heap->keys[i]>heap->keys[j];}
+    return heap->eqlfunc(heap->array[i],heap->array[j])==1;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * The inline version of max_heapify: moves the key and record at position i down the tree,
+ * choosing children by the contiguous keys only.
+ * @param heap A pointer to an inline MaxHeap.
+ * @param i The position that may violate the Max-Heap property.
+ */
+static void inline_heapify (MaxHeap heap, int i) {
+    int* keys=heap->keys;
+    int size=heap->rec_size;
+    int key=keys[i];
+    int d=heap->arity;
+    memcpy(heap->scratch,heap->records+(size_t)i*size,size);
+
+    while (d*i+1<heap->capacity) {
+        int first=d*i+1;
+        int last=first+d<heap->capacity ? first+d : heap->capacity;
+        if (d*first+1<heap->capacity) {PREFETCH_SLOT(&keys[d*first+1]);}
+
+        int largest=first;
+        for (int c=first+1; c<last; c++) {
+            if (keys[c]>keys[largest]) {largest=c;}
+        }
+        if (keys[largest]<=key) {break;}
+        keys[i]=keys[largest];
+        memcpy(heap->records+(size_t)i*size,heap->records+(size_t)largest*size,size);
+        i=largest;
+    }
+    keys[i]=key;
+    memcpy(heap->records+(size_t)i*size,heap->scratch,size);
+}
+
+/**
+ * Auxiliary function for self use only.
+ * The inline version of sift_up.
+ * @param heap A pointer to an inline MaxHeap.
+ * @param i The position that may be larger than its parent.
+ */
+static void inline_sift_up (MaxHeap heap, int i) {
+    int* keys=heap->keys;
+    int size=heap->rec_size;
+    int key=keys[i];
+    int d=heap->arity;
+    memcpy(heap->scratch,heap->records+(size_t)i*size,size);
+
+    while (i>0 && key>keys[(i-1)/d]) {
+        keys[i]=keys[(i-1)/d];
+        memcpy(heap->records+(size_t)i*size,heap->records+(size_t)((i-1)/d)*size,size);
+        i=(i-1)/d;
+    }
+    keys[i]=key;
+    memcpy(heap->records+(size_t)i*size,heap->scratch,size);
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Swaps the elements at two positions of a pointer heap, together with their handles.
+ * @param heap A pointer to the MaxHeap structure.
+ * @param a The first position.
+ * @param b The second position.
+ */
+static void swap_slots (MaxHeap heap, int a, int b) {
+    element temp=heap->array[a];
+    heap->array[a]=heap->array[b];
+    heap->array[b]=temp;
+    if (heap->heap_handle) {
+        int h=heap->heap_handle[a];
+        heap->heap_handle[a]=heap->heap_handle[b];
+        heap->heap_handle[b]=h;
+        heap->handle_pos[heap->heap_handle[a]]=a;
+        heap->handle_pos[heap->heap_handle[b]]=b;
+    }
+}
+/**
+ * Auxiliary function for self use only.
+ * Checks whether a position of a min-max heap is on a max level (depth 0, 2, 4...).
+ * @param i The position in the heap.
+ * @return 1 for a max level, 0 for a min level.
+ */
+static int is_max_level (int i) {
+    int depth=0;
+    for (i=i+1; i>1; i/=2) {depth++;}
+    return depth%2==0;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Checks whether the element at position i should be above the element at position j on a level of the given kind:
+ * larger on a max level, smaller on a min level.
+ * @return 1 if so, otherwise 0.
+ */
+static int mm_before (MaxHeap heap, int i, int j, int max_level) {
+    int cmp=heap->eqlfunc(heap->array[i],heap->array[j]);
+    return max_level ? cmp==1 : cmp==-1;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Moves the element at position i of a min-max heap up through the levels of its own kind (every second level).
+ * @param heap A pointer to a min-max MaxHeap.
+ * @param i The position of the element.
+ * @param max_level Whether i is on a max level.
+ */
+static void mm_bubble_up_levels (MaxHeap heap, int i, int max_level) {
+    while (i>2) {
+        int g=((i-1)/2-1)/2;
+        if (!mm_before(heap,i,g,max_level)) {break;}
+        swap_slots(heap,i,g);
+        i=g;
+    }
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Moves the element at position i of a min-max heap down until its subtree is valid again,
+ * assuming the subtrees of its children are valid.
+ * @param heap A pointer to a min-max MaxHeap.
+ * @param i The position of the element.
+ */
+static void mm_trickle_down (MaxHeap heap, int i) {
+    int max_level=is_max_level(i);
+    while (2*i+1<heap->capacity) {
+        //The best among the children and grandchildren: largest on a max level, smallest on a min level
+        int m=2*i+1;
+        int candidates[6]={2*i+2,4*i+3,4*i+4,4*i+5,4*i+6,-1};
+        for (int c=0; candidates[c]!=-1 && candidates[c]<heap->capacity; c++) {
+            if (mm_before(heap,candidates[c],m,max_level)) {m=candidates[c];}
+        }
+        if (!mm_before(heap,m,i,max_level)) {break;}
+        swap_slots(heap,i,m);
+
+        //A child is on the other kind of level and is a leaf of this subtree, nothing below it moves
+        if (m<=2*i+2) {break;}
+
+        //A grandchild must still respect its parent, which is on the other kind of level
+        if (mm_before(heap,(m-1)/2,m,max_level)) {swap_slots(heap,m,(m-1)/2);}
+        i=m;
+    }
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Restores a min-max heap after the element at position i was replaced or changed.
+ * @param heap A pointer to a min-max MaxHeap.
+ * @param i The position of the changed element.
+ */
+static void mm_fix (MaxHeap heap, int i) {
+    int max_level=is_max_level(i);
+
+    //Out of order with its parent: they swap, the parent's old element settles below and the element climbs the other kind of levels
+    if (i>0 && mm_before(heap,(i-1)/2,i,max_level)) {
+        int p=(i-1)/2;
+        swap_slots(heap,i,p);
+        mm_trickle_down(heap,i);
+        mm_bubble_up_levels(heap,p,!max_level);
+        return;
+    }
+    //Out of order with its grandparent: it climbs its own kind of levels, whatever comes down still fits below
+    if (i>2 && mm_before(heap,i,((i-1)/2-1)/2,max_level)) {
+        mm_bubble_up_levels(heap,i,max_level);
+        return;
+    }
+    mm_trickle_down(heap,i);
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Maintains the Max-Heap property by moving an element down the tree.
+ * The element is held aside while the larger children move up into the hole,
+ * so every element is written once instead of being swapped at each level.
  * @param heap A pointer to the MaxHeap structure.
  * @param i The index of the node that may violate the Max-Heap property.
  * @return Void.
@@ -31,37 +289,188 @@ struct MaxHeap_s {
 static void max_heapify (MaxHeap heap, int i) {
     //input validation
     if (!heap) {return;}
+    if (heap->kind==inline_heap) {
+        inline_heapify(heap,i);
+        return;
+    }
+    if (heap->kind==minmax_heap) {
+        mm_trickle_down(heap,i);
+        return;
+    }
+
+    element* arr=heap->array;
+    element moving=arr[i];
+    int* hh=heap->heap_handle;
+    int moving_handle=hh ? hh[i] : -1;
+    int d=heap->arity;
+
+    while (d*i+1<heap->capacity) {
+        int first=d*i+1;
+        int last=first+d<heap->capacity ? first+d : heap->capacity;
+
+        //The children of 'first' are the next block we may visit
+        if (d*first+1<heap->capacity) {PREFETCH_SLOT(&arr[d*first+1]);}
+
+        int largest=first;
+        for (int c=first+1; c<last; c++) {
+            if (heap->eqlfunc(arr[c],arr[largest])==1) {largest=c;}
+        }
+        if (heap->eqlfunc(arr[largest],moving)!=1) {break;}
+        arr[i]=arr[largest];
+        if (hh) {
+            hh[i]=hh[largest];
+            heap->handle_pos[hh[i]]=i;
+        }
+        i=largest;
+    }
+    arr[i]=moving;
+    if (hh) {
+        hh[i]=moving_handle;
+        heap->handle_pos[moving_handle]=i;
+    }
+}
 
-    int largest;
-    int l = 2*i+1;
-    int r = 2*i+2;
+/**
+ * Auxiliary function for self use only.
+ * Maintains the Max-Heap property by moving an element up the tree, using the same hole technique as max_heapify.
+ * @param heap A pointer to the MaxHeap structure.
+ * @param i The index of the node that may be larger than its parent.
+ * @return Void.
+ */
+static void sift_up (MaxHeap heap, int i) {
+    if (heap->kind==inline_heap) {
+        inline_sift_up(heap,i);
+        return;
+    }
+    if (heap->kind==minmax_heap) {
+        mm_fix(heap,i);
+        return;
+    }
+    element* arr=heap->array;
+    element moving=arr[i];
+    int* hh=heap->heap_handle;
+    int moving_handle=hh ? hh[i] : -1;
+    int d=heap->arity;
 
-    if (l<heap->capacity && heap->eqlfunc(heap->array[l],heap->array[i])==1) {
-        largest=l;
+    while (i>0 && heap->eqlfunc(moving,arr[(i-1)/d])==1) {
+        arr[i]=arr[(i-1)/d];
+        if (hh) {
+            hh[i]=hh[(i-1)/d];
+            heap->handle_pos[hh[i]]=i;
+        }
+        i=(i-1)/d;
+    }
+    arr[i]=moving;
+    if (hh) {
+        hh[i]=moving_handle;
+        heap->handle_pos[moving_handle]=i;
     }
-    else {largest=i;}
-    if (r<heap->capacity && heap->eqlfunc(heap->array[r],heap->array[largest])==1) {
-        largest=r;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Grows the handle maps of an indexed heap to 'slots' entries. The maps never shrink,
+ * so a handle keeps its number for as long as its element stays in the heap.
+ * @param heap A pointer to an indexed MaxHeap structure.
+ * @param slots The new number of handles.
+ * @return success if the maps are large enough, or memory_error if the reallocation failed.
+ */
+static status resize_handles(MaxHeap heap, int slots) {
+    if (slots<=heap->handle_slots) {return success;}
+    int* temp_hh=(int*)realloc(heap->heap_handle,sizeof(int)*slots);
+    if (!temp_hh) {return memory_error;}
+    heap->heap_handle=temp_hh;
+    int* temp_hp=(int*)realloc(heap->handle_pos,sizeof(int)*slots);
+    if (!temp_hp) {return memory_error;}
+    heap->handle_pos=temp_hp;
+
+    //The new handles are free, each one parked at the position with its own number
+    for (int i=heap->handle_slots; i<slots; i++) {
+        heap->heap_handle[i]=i;
+        heap->handle_pos[i]=i;
+    }
+    heap->handle_slots=slots;
+    return success;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Reallocates the array of the heap to hold exactly 'slots' elements.
+ * @param heap A pointer to the MaxHeap structure.
+ * @param slots The new number of slots, must not be smaller than the current size.
+ * @return success if the array was resized, or memory_error if the reallocation failed.
+ */
+static status resize_array(MaxHeap heap, int slots) {
+    if (slots<1) {slots=1;}
+    if (heap->kind==bucket_heap) {
+        int* temp_next=(int*)realloc(heap->slot_next,sizeof(int)*slots);
+        if (!temp_next) {return memory_error;}
+        heap->slot_next=temp_next;
+        element* temp_arr=(element*)realloc(heap->array,sizeof(element)*slots);
+        if (!temp_arr) {return memory_error;}
+        heap->array=temp_arr;
+
+        //Chaining the new slots into the free list
+        for (int i=slots-1; i>=heap->allocated; i--) {
+            heap->slot_next[i]=heap->free_slot;
+            heap->free_slot=i;
+        }
+        heap->allocated=slots;
+        return success;
     }
-    if (largest!=i) {
-        element temp=heap->array[i];
-        heap->array[i]=heap->array[largest];
-        heap->array[largest]=temp;
-        max_heapify(heap,largest);
+    if (heap->kind==inline_heap) {
+        int* temp_keys=(int*)realloc(heap->keys,sizeof(int)*slots);
+        if (!temp_keys) {return memory_error;}
+        heap->keys=temp_keys;
+        char* temp_records=(char*)realloc(heap->records,(size_t)heap->rec_size*slots);
+        if (!temp_records) {return memory_error;}
+        heap->records=temp_records;
+        heap->allocated=slots;
+        return success;
     }
+    if (heap->heap_handle && resize_handles(heap,slots)!=success) {return memory_error;}
+    element* temp_arr=(element*)realloc(heap->array,sizeof(element)*slots);
+    if (!temp_arr) {return memory_error;}
+    heap->array=temp_arr;
+    heap->allocated=slots;
+    return success;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Makes sure the array has room for at least one more element, doubling the
+ * number of slots when it is full. A bounded heap never grows beyond MaxSize.
+ * @param heap A pointer to the MaxHeap structure.
+ * @return success if there is room, failure_fullcapacity if the heap reached MaxSize,
+ * or memory_error if the array could not be grown.
+ */
+static status grow_if_needed(MaxHeap heap) {
+    if (heap->MaxSize!=UNBOUNDED_CAPACITY && heap->capacity>=heap->MaxSize) {return failure_fullcapacity;}
+    if (heap->capacity<heap->allocated) {return success;}
+
+    int slots=heap->allocated*2;
+    if (heap->MaxSize!=UNBOUNDED_CAPACITY && slots>heap->MaxSize) {slots=heap->MaxSize;}
+    return resize_array(heap,slots);
 }
 
 MaxHeap createHeap(char* name, int Max, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc) {
+    return createHeapWithArity(name,Max,HEAP_DEFAULT_ARITY,copyFunc,freeFunc,printFunc,eqlFunc);
+}
+
+MaxHeap createHeapWithArity(char* name, int Max, int arity, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc) {
     //input validation
-    if (!name || !copyFunc || !freeFunc || !printFunc || !eqlFunc || Max<0 ) {return NULL;}
+    if (!name || !copyFunc || !freeFunc || !printFunc || !eqlFunc || (Max<0 && Max!=UNBOUNDED_CAPACITY)) {return NULL;}
+    if (arity!=2 && arity!=4 && arity!=8) {return NULL;}
 
     //Allocating memory and deep copying the string representing the heap name
     char* temp_name=(char*)malloc(strlen(name)+1);
     if (!temp_name) {return NULL;}
     strcpy(temp_name,name);
 
-    //Allocating memory for the array
-    element* temp_arr=(element*)malloc(sizeof(element)*Max);
+    //Allocating a small initial array, the heap grows on demand so sparse heaps do not reserve Max slots up front
+    int slots=HEAP_INITIAL_SLOTS;
+    if (Max!=UNBOUNDED_CAPACITY && Max<slots) {slots=Max>0 ? Max : 1;}
+    element* temp_arr=(element*)malloc(sizeof(element)*slots);
     if (!temp_arr) {
         free(temp_name);
         return NULL;
@@ -76,8 +485,25 @@ MaxHeap createHeap(char* name, int Max, copyFunction copyFunc, freeFunction free
     }
 
     //Initializing the struct members with the relevant values
+    heap->kind=pointer_heap;
     heap->array=temp_arr;
+    heap->bucket_head=NULL;
+    heap->slot_next=NULL;
+    heap->min_key=0;
+    heap->num_buckets=0;
+    heap->top_bucket=-1;
+    heap->free_slot=-1;
+    heap->heap_handle=NULL;
+    heap->handle_pos=NULL;
+    heap->handle_slots=0;
+    heap->records=NULL;
+    heap->keys=NULL;
+    heap->scratch=NULL;
+    heap->rec_size=0;
+    heap->getkeyfunc=NULL;
+    heap->arity=arity;
     heap->MaxSize=Max;
+    heap->allocated=slots;
     heap->capacity=0;
     heap->h_name=temp_name;
     heap->copyfunc=copyFunc;
@@ -87,13 +513,191 @@ MaxHeap createHeap(char* name, int Max, copyFunction copyFunc, freeFunction free
     return heap;
 }
 
+MaxHeap createIndexedHeap(char* name, int Max, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc) {
+    MaxHeap heap=createHeap(name,Max,copyFunc,freeFunc,printFunc,eqlFunc);
+    if (!heap) {return NULL;}
+
+    //Turning on the handle maps, sized like the array
+    if (resize_handles(heap,heap->allocated)!=success) {
+        destroyHeap(heap);
+        return NULL;
+    }
+    return heap;
+}
+
+MaxHeap createInlineHeap(char* name, int Max, int elemSize, getKeyFunction getKey, printFunction printFunc) {
+    //input validation
+    if (!name || !getKey || !printFunc || elemSize<=0 || (Max<0 && Max!=UNBOUNDED_CAPACITY)) {return NULL;}
+
+    //Allocating memory and deep copying the string representing the heap name
+    char* temp_name=(char*)malloc(strlen(name)+1);
+    if (!temp_name) {return NULL;}
+    strcpy(temp_name,name);
+
+    //Allocating memory for the struct itself
+    MaxHeap heap=(MaxHeap)malloc(sizeof(struct MaxHeap_s));
+    if (!heap) {
+        free(temp_name);
+        return NULL;
+    }
+
+    //Initializing the struct members, the records and keys are allocated by resize_array below
+    heap->kind=inline_heap;
+    heap->array=NULL;
+    heap->bucket_head=NULL;
+    heap->slot_next=NULL;
+    heap->min_key=0;
+    heap->num_buckets=0;
+    heap->top_bucket=-1;
+    heap->free_slot=-1;
+    heap->heap_handle=NULL;
+    heap->handle_pos=NULL;
+    heap->handle_slots=0;
+    heap->records=NULL;
+    heap->keys=NULL;
+    heap->rec_size=elemSize;
+    heap->getkeyfunc=getKey;
+    heap->arity=HEAP_DEFAULT_ARITY;
+    heap->MaxSize=Max;
+    heap->allocated=0;
+    heap->capacity=0;
+    heap->h_name=temp_name;
+    heap->copyfunc=NULL;
+    heap->freefunc=NULL;
+    heap->printfunc=printFunc;
+    heap->eqlfunc=NULL;
+
+    int slots=HEAP_INITIAL_SLOTS;
+    if (Max!=UNBOUNDED_CAPACITY && Max<slots) {slots=Max>0 ? Max : 1;}
+    heap->scratch=(char*)malloc(elemSize);
+    if (!heap->scratch || resize_array(heap,slots)!=success) {
+        destroyHeap(heap);
+        return NULL;
+    }
+    return heap;
+}
+
+MaxHeap createBucketHeap(char* name, int Max, int minKey, int maxKey, getKeyFunction getKey, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc) {
+    //input validation
+    if (!name || !getKey || !copyFunc || !freeFunc || !printFunc || minKey>maxKey || (Max<0 && Max!=UNBOUNDED_CAPACITY)) {return NULL;}
+    if ((long)maxKey-(long)minKey+1>HEAP_MAX_BUCKETS) {return NULL;}
+
+    //Allocating memory and deep copying the string representing the heap name
+    char* temp_name=(char*)malloc(strlen(name)+1);
+    if (!temp_name) {return NULL;}
+    strcpy(temp_name,name);
+
+    //Allocating memory for the struct itself
+    MaxHeap heap=(MaxHeap)malloc(sizeof(struct MaxHeap_s));
+    if (!heap) {
+        free(temp_name);
+        return NULL;
+    }
+
+    //Initializing the struct members, the slots are allocated by resize_array below
+    heap->kind=bucket_heap;
+    heap->array=NULL;
+    heap->slot_next=NULL;
+    heap->min_key=minKey;
+    heap->num_buckets=maxKey-minKey+1;
+    heap->top_bucket=-1;
+    heap->free_slot=-1;
+    heap->heap_handle=NULL;
+    heap->handle_pos=NULL;
+    heap->handle_slots=0;
+    heap->records=NULL;
+    heap->keys=NULL;
+    heap->scratch=NULL;
+    heap->rec_size=0;
+    heap->getkeyfunc=getKey;
+    heap->arity=HEAP_DEFAULT_ARITY;
+    heap->MaxSize=Max;
+    heap->allocated=0;
+    heap->capacity=0;
+    heap->h_name=temp_name;
+    heap->copyfunc=copyFunc;
+    heap->freefunc=freeFunc;
+    heap->printfunc=printFunc;
+    heap->eqlfunc=NULL;
+
+    //All buckets start empty
+    heap->bucket_head=(int*)malloc(sizeof(int)*heap->num_buckets);
+    if (!heap->bucket_head) {
+        destroyHeap(heap);
+        return NULL;
+    }
+    for (int k=0; k<heap->num_buckets; k++) {heap->bucket_head[k]=-1;}
+
+    int slots=HEAP_INITIAL_SLOTS;
+    if (Max!=UNBOUNDED_CAPACITY && Max<slots) {slots=Max>0 ? Max : 1;}
+    if (resize_array(heap,slots)!=success) {
+        destroyHeap(heap);
+        return NULL;
+    }
+    return heap;
+}
+
 MaxHeap copyHeap(MaxHeap old) {
     //input validation
     if (!old) {return NULL;}
 
+    //A bucket heap is copied bucket by bucket
+    if (old->kind==bucket_heap) {
+        MaxHeap new_heap=createBucketHeap(old->h_name,old->MaxSize,old->min_key,old->min_key+old->num_buckets-1,old->getkeyfunc,old->copyfunc,old->freefunc,old->printfunc);
+        if (!new_heap) {return NULL;}
+        if (reserveHeap(new_heap,old->capacity)!=success) {
+            destroyHeap(new_heap);
+            return NULL;
+        }
+        for (int k=0; k<old->num_buckets; k++) {
+            for (int slot=old->bucket_head[k]; slot!=-1; slot=old->slot_next[slot]) {
+                element to_add=old->copyfunc(old->array[slot]);
+                if (!to_add) {
+                    destroyHeap(new_heap);
+                    return NULL;
+                }
+                insertToHeapOwned(new_heap,to_add);
+            }
+        }
+        return new_heap;
+    }
+
+    //An inline heap is copied record by record with a single memcpy
+    if (old->kind==inline_heap) {
+        MaxHeap new_heap=createInlineHeap(old->h_name,old->MaxSize,old->rec_size,old->getkeyfunc,old->printfunc);
+        if (!new_heap) {return NULL;}
+        if (reserveHeap(new_heap,old->capacity)!=success) {
+            destroyHeap(new_heap);
+            return NULL;
+        }
+        memcpy(new_heap->keys,old->keys,sizeof(int)*old->capacity);
+        memcpy(new_heap->records,old->records,(size_t)old->rec_size*old->capacity);
+        new_heap->capacity=old->capacity;
+        return new_heap;
+    }
+
     //Creating a copy of the existing heap by using the existing heap members and a function that creates a new heap.
-    MaxHeap new_heap=createHeap(old->h_name,old->MaxSize,old->copyfunc,old->freefunc,old->printfunc,old->eqlfunc);
+    MaxHeap new_heap;
+    if (old->kind==minmax_heap) {
+        new_heap=createMinMaxHeap(old->h_name,old->MaxSize,old->copyfunc,old->freefunc,old->printfunc,old->eqlfunc);
+    } else {
+        new_heap=createHeapWithArity(old->h_name,old->MaxSize,old->arity,old->copyfunc,old->freefunc,old->printfunc,old->eqlfunc);
+    }
     if (!new_heap) {return NULL;}
+    if (reserveHeap(new_heap,old->capacity)!=success) {
+        destroyHeap(new_heap);
+        return NULL;
+    }
+
+    //An indexed copy gets the same handle numbers as the original
+    if (old->heap_handle) {
+        if (resize_handles(new_heap,old->handle_slots)!=success) {
+            destroyHeap(new_heap);
+            return NULL;
+        }
+        memcpy(new_heap->heap_handle,old->heap_handle,sizeof(int)*old->handle_slots);
+        memcpy(new_heap->handle_pos,old->handle_pos,sizeof(int)*old->handle_slots);
+    }
 
     //deepcopy of the array whose represent the heap itself.
     for (int i=0; i<old->capacity; i++) {
@@ -112,56 +716,252 @@ status destroyHeap(MaxHeap heap) {
     //input validation
     if (!heap) {return failure;}
 
-    //destroy all the elements in the array first according to inside out principle.
-    for (int i=0; i<heap->capacity; i++) {
-        heap->freefunc(heap->array[i]);
+    //destroy all the elements in the array first according to inside out principle (inline records are plain values).
+    if (heap->kind==pointer_heap || heap->kind==minmax_heap) {
+        for (int i=0; i<heap->capacity; i++) {
+            heap->freefunc(heap->array[i]);
+        }
+    }
+    //in a bucket heap only the chained slots hold elements
+    if (heap->kind==bucket_heap && heap->bucket_head) {
+        for (int k=0; k<heap->num_buckets; k++) {
+            for (int slot=heap->bucket_head[k]; slot!=-1; slot=heap->slot_next[slot]) {
+                heap->freefunc(heap->array[slot]);
+            }
+        }
     }
     //free the fields of the structure itself that are stored in the heap
     free(heap->array);
+    free(heap->bucket_head);
+    free(heap->slot_next);
+    free(heap->heap_handle);
+    free(heap->handle_pos);
+    free(heap->records);
+    free(heap->keys);
+    free(heap->scratch);
     free(heap->h_name);
     free(heap);
     return success;
 }
 
+/**
+ * Auxiliary function for self use only.
+ * Orders two candidates of an iterator frontier: the larger element first, and of two equal elements
+ * the one at the lower position, so the iterator visits equal elements in a fixed order.
+ * @param heap A pointer to the iterated MaxHeap.
+ * @param i The position of the first candidate.
+ * @param j The position of the second candidate.
+ * @return 1 if the candidate at i comes first, otherwise 0.
+ */
+static int frontier_before(MaxHeap heap, int i, int j) {
+    if (slot_greater(heap,i,j)) {return 1;}
+    return !slot_greater(heap,j,i) && i<j;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Pushes an index of the heap's array into the iterator frontier, keeping the frontier a max-heap.
+ * @param it A pointer to the iterator.
+ * @param idx The index to push.
+ * @return success if pushed, or memory_error if growing the frontier failed.
+ */
+static status frontier_push(HeapIterator it, int idx) {
+    if (it->size==it->slots) {
+        int slots = it->slots>0 ? it->slots*2 : HEAP_INITIAL_SLOTS;
+        int* temp=(int*)realloc(it->frontier,sizeof(int)*slots);
+        if (!temp) {return memory_error;}
+        it->frontier=temp;
+        it->slots=slots;
+    }
+    int i=it->size;
+    it->size++;
+    while (i>0 && frontier_before(it->heap,idx,it->frontier[(i-1)/2])) {
+        it->frontier[i]=it->frontier[(i-1)/2];
+        i=(i-1)/2;
+    }
+    it->frontier[i]=idx;
+    return success;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Removes and returns the index of the largest candidate in the iterator frontier.
+ * @param it A pointer to the iterator, its frontier must not be empty.
+ * @return The index in the heap's array of the next largest element.
+ */
+static int frontier_pop(HeapIterator it) {
+    int top=it->frontier[0];
+    it->size--;
+    int last=it->frontier[it->size];
+    int i=0;
+    while (2*i+1<it->size) {
+        int child=2*i+1;
+        if (child+1<it->size && frontier_before(it->heap,it->frontier[child+1],it->frontier[child])) {child++;}
+        if (!frontier_before(it->heap,it->frontier[child],last)) {break;}
+        it->frontier[i]=it->frontier[child];
+        i=child;
+    }
+    it->frontier[i]=last;
+    return top;
+}
+
+HeapIterator createHeapIterator(MaxHeap heap) {
+    //input validation
+    if (!heap) {return NULL;}
+
+    HeapIterator it=(HeapIterator)malloc(sizeof(struct HeapIterator_s));
+    if (!it) {return NULL;}
+    it->heap=heap;
+    it->frontier=NULL;
+    it->size=0;
+    it->slots=0;
+
+    //A bucket heap is already ordered, the iterator walks the chains from the top bucket down
+    it->bucket=heap->top_bucket;
+    it->slot=-1;
+    if (heap->kind==bucket_heap) {
+        if (heap->capacity>0) {it->slot=heap->bucket_head[heap->top_bucket];}
+        return it;
+    }
+
+    //The root is the first candidate
+    if (heap->capacity>0 && frontier_push(it,0)!=success) {
+        free(it);
+        return NULL;
+    }
+    return it;
+}
+
+element nextInHeapIterator(HeapIterator it) {
+    //input validation
+    if (!it) {return NULL;}
+
+    if (it->heap->kind==bucket_heap) {
+        if (it->slot==-1) {return NULL;}
+        element elem=it->heap->array[it->slot];
+        it->slot=it->heap->slot_next[it->slot];
+        while (it->slot==-1 && it->bucket>0) {
+            it->bucket--;
+            it->slot=it->heap->bucket_head[it->bucket];
+        }
+        return elem;
+    }
+    if (it->size==0) {return NULL;}
+
+    //The children of the returned node become candidates, everything else in its subtree is smaller than them
+    int idx=frontier_pop(it);
+
+    //In a min-max heap a max-level node is larger than its children and grandchildren, and a min-level node's
+    //children are covered by their grandparent, so only max-level nodes add candidates
+    if (it->heap->kind==minmax_heap) {
+        if (is_max_level(idx)) {
+            int candidates[6]={2*idx+1,2*idx+2,4*idx+3,4*idx+4,4*idx+5,4*idx+6};
+            for (int c=0; c<6 && candidates[c]<it->heap->capacity; c++) {
+                if (frontier_push(it,candidates[c])!=success) {return NULL;}
+            }
+        }
+        return slot_elem(it->heap,idx);
+    }
+    int first=it->heap->arity*idx+1;
+    for (int c=first; c<first+it->heap->arity && c<it->heap->capacity; c++) {
+        if (frontier_push(it,c)!=success) {return NULL;}
+    }
+    return slot_elem(it->heap,idx);
+}
+
+void destroyHeapIterator(HeapIterator it) {
+    if (!it) {return;}
+    free(it->frontier);
+    free(it);
+}
+
+int topKMaxHeap(MaxHeap heap, int k, element out[]) {
+    //input validation
+    if (!heap || k<0 || (!out && k>0)) {return -1;}
+
+    HeapIterator it=createHeapIterator(heap);
+    if (!it) {return -1;}
+
+    int i=0;
+    while (i<k) {
+        element elem=nextInHeapIterator(it);
+        if (!elem) {break;}
+        out[i]=elem;
+        i++;
+    }
+    destroyHeapIterator(it);
+    return i;
+}
+
 status printHeap(MaxHeap heap) {
     //input validation
     if (!heap||!heap->h_name) {return failure;}
 
-    //copy of the origin heap in order to allow the heap to be destroyed by performing an extract max
-    MaxHeap newheap=copyHeap(heap);
-    if (!newheap) {return memory_error;}
+    //The heap is drained like a copy of it would be, with the same pops as PopMaxHeap so that equal elements
+    //are printed in the order they would be removed in. Only the storage is copied (element pointers, or
+    //the records and keys of an inline heap), so no element is copied or freed and the heap is untouched.
+    //A bucket heap is walked with an iterator instead, its chains are already in the order pops follow.
+    struct MaxHeap_s view=*heap;
+    view.heap_handle=NULL;
+    view.handle_pos=NULL;
+    element* array=NULL;
+    char* records=NULL;
+    int* keys=NULL;
+    HeapIterator it=NULL;
+    bool ok;
+    if (heap->kind==bucket_heap) {
+        it=createHeapIterator(heap);
+        ok=it!=NULL;
+    } else if (heap->kind==inline_heap) {
+        //One more record slot receives each popped record
+        records=(char*)malloc((size_t)heap->rec_size*(heap->capacity+1));
+        keys=(int*)malloc(sizeof(int)*(heap->capacity+1));
+        ok=records && keys;
+        if (ok) {
+            memcpy(records,heap->records,(size_t)heap->rec_size*heap->capacity);
+            memcpy(keys,heap->keys,sizeof(int)*heap->capacity);
+        }
+    } else {
+        array=(element*)malloc(sizeof(element)*(heap->capacity+1));
+        ok=array!=NULL;
+        if (ok) {memcpy(array,heap->array,sizeof(element)*heap->capacity);}
+    }
+    view.array=array;
+    view.records=records;
+    view.keys=keys;
+    if (!ok) {
+        free(array);
+        free(records);
+        free(keys);
+        return memory_error;
+    }
 
     //Printing the first line according to the requested format
-    printf("%s:\n",newheap->h_name);
+    printf("%s:\n",heap->h_name);
 
     //no elements in the heap
-    if (newheap->capacity<=0){
+    if (heap->capacity<=0){
         printf("No elements.\n\n");
-
-        //Deallocating memory for the copy of the heap we created
-        destroyHeap(newheap);
-        return success;
     }
 
-    //capacity>0
+    //Printing according to the requested format, from the largest element down
+    char* record = records ? records+(size_t)heap->rec_size*heap->capacity : NULL;
     int i=1;
-
-    //Holding a temporary pointer to the current maximum element on the heap.
-    element elem=PopMaxHeap(newheap);
-
-    //Removing all elements from the heap according to size
-    while (elem!=NULL) {
-        //Printing according to the requested format
+    while (true) {
+        element elem;
+        if (heap->kind==bucket_heap) {elem=nextInHeapIterator(it);}
+        else if (heap->kind==inline_heap) {elem=popMaxHeapInto(&view,record)==success ? record : NULL;}
+        else {elem=PopMaxHeap(&view);}
+        if (elem==NULL) {break;}
         printf("%d. ",i);
-        newheap->printfunc(elem);
-        //Deallocating the element that removed from the heap
-        newheap->freefunc(elem);
-        //Retrieving the next largest element from the heap
-        elem=PopMaxHeap(newheap);
+        heap->printfunc(elem);
         i++;
     }
-    //Deallocating memory for the copy of the heap we created
-    destroyHeap(newheap);
+
+    destroyHeapIterator(it);
+    free(array);
+    free(records);
+    free(keys);
     return success;
 }
 
@@ -176,6 +976,12 @@ char* getHeapid(MaxHeap heap) {
     return temp_name;
 }
 
+char* getHeapName(MaxHeap heap) {
+    //input validation
+    if (!heap) {return NULL;}
+    return heap->h_name;
+}
+
 int getHeapCurrentSize(MaxHeap heap) {
     //input validation
     if (!heap) {return -1;}
@@ -186,9 +992,30 @@ element PopMaxHeap(MaxHeap heap) {
     //input validation
     if (!heap || heap->capacity==0) {return NULL;}
 
-    //Retrieving the maximum element from the heap and updating the heap structure using a helper function
+    //A bucket heap unlinks the head of the top bucket and moves the top down to the next non-empty bucket
+    if (heap->kind==bucket_heap) {
+        int slot=heap->bucket_head[heap->top_bucket];
+        element max=heap->array[slot];
+        heap->bucket_head[heap->top_bucket]=heap->slot_next[slot];
+        heap->slot_next[slot]=heap->free_slot;
+        heap->free_slot=slot;
+        heap->capacity--;
+        while (heap->top_bucket>=0 && heap->bucket_head[heap->top_bucket]==-1) {heap->top_bucket--;}
+        return max;
+    }
+
+    //An inline heap hands out a heap allocated copy of the record
+    if (heap->kind==inline_heap) {
+        element max=malloc(heap->rec_size);
+        if (!max) {return NULL;}
+        popMaxHeapInto(heap,max);
+        return max;
+    }
+
+    //Retrieving the maximum element from the heap and updating the heap structure using a helper function.
+    //The swap keeps the released handle just past the end, among the free ones.
     element max=heap->array[0];
-    heap->array[0]=heap->array[heap->capacity-1];
+    swap_slots(heap,0,heap->capacity-1);
     heap->capacity--;
 
     if (heap->capacity>0) {
@@ -201,29 +1028,421 @@ element PopMaxHeap(MaxHeap heap) {
 element TopMaxHeap (MaxHeap heap) {
     //input validation
     if (!heap || heap->capacity==0) {return NULL;}
-    return heap->array[0];
+    if (heap->kind==bucket_heap) {return heap->array[heap->bucket_head[heap->top_bucket]];}
+    return slot_elem(heap,0);
+}
+
+element getHeapSlot(MaxHeap heap, int pos) {
+    //input validation
+    if (!heap || heap->kind==bucket_heap || pos<0 || pos>=heap->capacity) {return NULL;}
+    return slot_elem(heap,pos);
+}
+
+status popMaxHeapInto(MaxHeap heap, element out) {
+    //input validation
+    if (!heap || !out || heap->kind!=inline_heap) {return failure;}
+    if (heap->capacity==0) {return failure;}
+
+    //Copying the root record out, moving the last record into the root and restoring the heap rules
+    memcpy(out,heap->records,heap->rec_size);
+    heap->capacity--;
+    if (heap->capacity>0) {
+        heap->keys[0]=heap->keys[heap->capacity];
+        memcpy(heap->records,heap->records+(size_t)heap->capacity*heap->rec_size,heap->rec_size);
+        inline_heapify(heap,0);
+    }
+    return success;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Adds an element the heap already owns at the end of the array and moves it up to its place.
+ * @param heap A pointer to the MaxHeap structure.
+ * @param elem The element to be adopted.
+ * @param handle If not NULL and the heap is indexed, receives the handle of the new element.
+ * @return success if inserted, failure_fullcapacity if the heap is full, or memory_error if growing failed.
+ */
+static status insert_adopt(MaxHeap heap, element elem, int* handle) {
+    //A key outside the range of a bucket heap has no bucket
+    int bucket=0;
+    if (heap->kind==bucket_heap) {
+        bucket=heap->getkeyfunc(elem)-heap->min_key;
+        if (bucket<0 || bucket>=heap->num_buckets) {return failure;}
+    }
+
+    //full capacity, or growing the array failed
+    status st=grow_if_needed(heap);
+    if (st!=success) {return st;}
+
+    //A bucket heap pushes the element in front of its bucket chain, O(1)
+    if (heap->kind==bucket_heap) {
+        int slot=heap->free_slot;
+        heap->free_slot=heap->slot_next[slot];
+        heap->array[slot]=elem;
+        heap->slot_next[slot]=heap->bucket_head[bucket];
+        heap->bucket_head[bucket]=slot;
+        if (bucket>heap->top_bucket) {heap->top_bucket=bucket;}
+        heap->capacity++;
+        return success;
+    }
+
+    //Adding the new element to the last position in the array and rearranging the array according to heap rules
+    if (heap->kind==inline_heap) {
+        heap->keys[heap->capacity]=heap->getkeyfunc(elem);
+        memcpy(heap->records+(size_t)heap->capacity*heap->rec_size,elem,heap->rec_size);
+    } else {
+        heap->array[heap->capacity]=elem;
+    }
+    //The free handle parked at this position now belongs to the new element and moves with it
+    if (handle && heap->heap_handle) {*handle=heap->heap_handle[heap->capacity];}
+    heap->capacity++;
+    sift_up(heap,heap->capacity-1);
+    return success;
 }
 
 status insertToHeap(MaxHeap heap,element elem) {
     //input validation
     if (!heap || !elem ) {return failure;}
 
-    //full capacity
-    if (heap->capacity==heap->MaxSize){return failure_fullcapacity;}
+    //full capacity, or growing the array failed
+    status st=grow_if_needed(heap);
+    if (st!=success) {return st;}
+
+    //An inline heap stores the record bytes themselves, no copy function is involved
+    if (heap->kind==inline_heap) {return insertToHeapOwned(heap,elem);}
+
+    //The key must fit a bucket before a copy is made
+    if (heap->kind==bucket_heap) {
+        int bucket=heap->getkeyfunc(elem)-heap->min_key;
+        if (bucket<0 || bucket>=heap->num_buckets) {return failure;}
+    }
 
     //enough place to add 1 more element
     element to_add=heap->copyfunc(elem);
     if (!to_add) {return memory_error;}
 
-    //Adding the new element to the last position in the array and rearranging the array according to heap rules
-    heap->array[heap->capacity]=to_add;
-    heap->capacity++;
-    int i=heap->capacity-1;
-    while (i>0 && heap->eqlfunc(heap->array[i],heap->array[(i-1)/2])==1) {
-        element temp=heap->array[i];
-        heap->array[i]=heap->array[(i-1)/2];
-        heap->array[(i-1)/2]=temp;
-        i=(i-1)/2;
+    //The room was made above, so adopting the copy cannot fail
+    return insert_adopt(heap,to_add,NULL);
+}
+
+status insertToHeapOwned(MaxHeap heap,element elem) {
+    //input validation
+    if (!heap || !elem ) {return failure;}
+    return insert_adopt(heap,elem,NULL);
+}
+
+status reserveHeap(MaxHeap heap, int n) {
+    //input validation
+    if (!heap || n<0) {return failure;}
+
+    //a bounded heap will never hold more than MaxSize elements
+    if (heap->MaxSize!=UNBOUNDED_CAPACITY && n>heap->MaxSize) {return failure_fullcapacity;}
+    if (n<=heap->allocated) {return success;}
+    return resize_array(heap,n);
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Packs the used slots of a bucket heap into new arrays of exactly max(capacity,1) slots,
+ * keeping the order of every bucket chain.
+ * @param heap A pointer to a bucket MaxHeap.
+ * @return success if the heap was packed, or memory_error if the allocation failed.
+ */
+static status compact_buckets(MaxHeap heap) {
+    int slots=heap->capacity>0 ? heap->capacity : 1;
+    element* new_arr=(element*)malloc(sizeof(element)*slots);
+    int* new_next=(int*)malloc(sizeof(int)*slots);
+    if (!new_arr || !new_next) {
+        free(new_arr);
+        free(new_next);
+        return memory_error;
+    }
+
+    int j=0;
+    for (int k=0; k<heap->num_buckets; k++) {
+        int slot=heap->bucket_head[k];
+        if (slot==-1) {continue;}
+        heap->bucket_head[k]=j;
+        while (slot!=-1) {
+            new_arr[j]=heap->array[slot];
+            slot=heap->slot_next[slot];
+            new_next[j]=slot==-1 ? -1 : j+1;
+            j++;
+        }
+    }
+    //Whatever is left (one slot at most, for an empty heap) is free
+    heap->free_slot=-1;
+    for (int i=slots-1; i>=j; i--) {
+        new_next[i]=heap->free_slot;
+        heap->free_slot=i;
+    }
+    free(heap->array);
+    free(heap->slot_next);
+    heap->array=new_arr;
+    heap->slot_next=new_next;
+    heap->allocated=slots;
+    return success;
+}
+
+status shrinkHeapToFit(MaxHeap heap) {
+    //input validation
+    if (!heap) {return failure;}
+    if (heap->allocated==heap->capacity) {return success;}
+    //the free slots of a bucket heap are scattered, so it is packed rather than truncated
+    if (heap->kind==bucket_heap) {return compact_buckets(heap);}
+    return resize_array(heap,heap->capacity);
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Restores the heap rules of a whole pointer, min-max or inline heap bottom-up (Floyd's build-heap, O(n)).
+ * @param heap A pointer to the MaxHeap structure.
+ */
+static void build_heap(MaxHeap heap) {
+    //(capacity-2)/arity is the parent of the last element
+    if (heap->capacity>1) {
+        for (int i=(heap->capacity-2)/heap->arity; i>=0; i--) {
+            max_heapify(heap,i);
+        }
+    }
+}
+
+status heapifyBulk(MaxHeap heap, element* elems, int n) {
+    //input validation
+    if (!heap || (!elems && n>0) || n<0) {return failure;}
+    for (int i=0; i<n; i++) {
+        if (!elems[i]) {return failure;}
+    }
+
+    //Every key must fit a bucket before anything is adopted
+    if (heap->kind==bucket_heap) {
+        for (int i=0; i<n; i++) {
+            int bucket=heap->getkeyfunc(elems[i])-heap->min_key;
+            if (bucket<0 || bucket>=heap->num_buckets) {return failure;}
+        }
+    }
+
+    //Making room for the whole batch first, so a failure leaves the elements owned by the caller
+    status st=reserveHeap(heap,heap->capacity+n);
+    if (st!=success) {return st;}
+
+    //A bucket heap needs no ordering pass, each insertion is O(1) and cannot fail after the reservation
+    if (heap->kind==bucket_heap) {
+        for (int i=0; i<n; i++) {
+            insert_adopt(heap,elems[i],NULL);
+        }
+        return success;
     }
+
+    //Appending the batch as is, without copies, and restoring the heap rules bottom-up (Floyd's build-heap, O(n))
+    if (heap->kind==inline_heap) {
+        for (int i=0; i<n; i++) {
+            heap->keys[heap->capacity+i]=heap->getkeyfunc(elems[i]);
+            memcpy(heap->records+(size_t)(heap->capacity+i)*heap->rec_size,elems[i],heap->rec_size);
+        }
+    } else {
+        memcpy(heap->array+heap->capacity,elems,sizeof(element)*n);
+    }
+    heap->capacity+=n;
+    build_heap(heap);
     return success;
+}
+
+MaxHeap buildHeapFromArray(char* name, int Max, element* elems, int n, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc) {
+    MaxHeap heap=createHeap(name,Max,copyFunc,freeFunc,printFunc,eqlFunc);
+    if (!heap) {return NULL;}
+
+    //On failure nothing was adopted, so destroying the empty heap leaves the elements untouched
+    if (heapifyBulk(heap,elems,n)!=success) {
+        destroyHeap(heap);
+        return NULL;
+    }
+    return heap;
+}
+
+status meldHeaps(MaxHeap dst, MaxHeap src) {
+    //input validation
+    if (!dst || !src || dst==src) {return failure;}
+    if ((dst->kind==inline_heap)!=(src->kind==inline_heap)) {return failure;}
+    if (dst->kind==inline_heap && dst->rec_size!=src->rec_size) {return failure;}
+    if (src->capacity==0) {return success;}
+    int n=src->capacity;
+
+    //Inline records are appended byte by byte, then the whole heap is rebuilt once
+    if (src->kind==inline_heap) {
+        status st=reserveHeap(dst,dst->capacity+n);
+        if (st!=success) {return st;}
+        memcpy(dst->keys+dst->capacity,src->keys,sizeof(int)*n);
+        memcpy(dst->records+(size_t)dst->capacity*dst->rec_size,src->records,(size_t)n*src->rec_size);
+        dst->capacity+=n;
+        src->capacity=0;
+        build_heap(dst);
+        return success;
+    }
+
+    //The used slots of a bucket heap are scattered, packing them makes array[0..n) the element list
+    if (src->kind==bucket_heap && compact_buckets(src)!=success) {return memory_error;}
+
+    //The element pointers move as they are, heapifyBulk checks the room and the keys before adopting any of them
+    status st=heapifyBulk(dst,src->array,n);
+    if (st!=success) {return st;}
+
+    //src is left empty, its handles no longer refer to anything
+    src->capacity=0;
+    if (src->kind==bucket_heap) {
+        for (int b=0; b<src->num_buckets; b++) {src->bucket_head[b]=-1;}
+        src->top_bucket=-1;
+        src->free_slot=-1;
+        for (int i=src->allocated-1; i>=0; i--) {
+            src->slot_next[i]=src->free_slot;
+            src->free_slot=i;
+        }
+    }
+    return success;
+}
+
+status insertWithHandle(MaxHeap heap, element elem, int* handle) {
+    //input validation
+    if (!heap || !elem || !handle || !heap->heap_handle) {return failure;}
+
+    //full capacity, or growing the array failed
+    status st=grow_if_needed(heap);
+    if (st!=success) {return st;}
+
+    element to_add=heap->copyfunc(elem);
+    if (!to_add) {return memory_error;}
+    return insert_adopt(heap,to_add,handle);
+}
+
+status insertOwnedWithHandle(MaxHeap heap, element elem, int* handle) {
+    //input validation
+    if (!heap || !elem || !handle || !heap->heap_handle) {return failure;}
+    return insert_adopt(heap,elem,handle);
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Translates a handle to the current position of its element.
+ * @param heap A pointer to the MaxHeap structure.
+ * @param handle The handle to translate.
+ * @return The position of the element, or -1 if the heap is not indexed or the handle is not in use.
+ */
+static int handle_to_pos(MaxHeap heap, int handle) {
+    if (!heap || !heap->heap_handle || handle<0 || handle>=heap->handle_slots) {return -1;}
+    int pos=heap->handle_pos[handle];
+    if (pos>=heap->capacity) {return -1;}
+    return pos;
+}
+
+element getByHandle(MaxHeap heap, int handle) {
+    int pos=handle_to_pos(heap,handle);
+    if (pos<0) {return NULL;}
+    return heap->array[pos];
+}
+
+int findHandleInHeap(MaxHeap heap, element key, equalFunction match) {
+    //input validation
+    if (!heap || !key || !match || !heap->heap_handle) {return -1;}
+
+    //Scanning the contiguous array, the position is then translated to the element's handle
+    for (int i=0; i<heap->capacity; i++) {
+        if (match(heap->array[i],key)==0) {return heap->heap_handle[i];}
+    }
+    return -1;
+}
+
+status increaseKey(MaxHeap heap, int handle) {
+    int pos=handle_to_pos(heap,handle);
+    if (pos<0) {return failure;}
+    if (heap->kind==minmax_heap) {return updateKey(heap,handle);}
+    sift_up(heap,pos);
+    return success;
+}
+
+status decreaseKey(MaxHeap heap, int handle) {
+    int pos=handle_to_pos(heap,handle);
+    if (pos<0) {return failure;}
+    if (heap->kind==minmax_heap) {return updateKey(heap,handle);}
+    max_heapify(heap,pos);
+    return success;
+}
+
+status updateKey(MaxHeap heap, int handle) {
+    int pos=handle_to_pos(heap,handle);
+    if (pos<0) {return failure;}
+
+    //In a min-max heap the direction depends on the level, mm_fix handles both
+    if (heap->kind==minmax_heap) {
+        mm_fix(heap,pos);
+        return success;
+    }
+
+    //Only one of the two directions can move the element
+    if (pos>0 && heap->eqlfunc(heap->array[pos],heap->array[(pos-1)/heap->arity])==1) {
+        sift_up(heap,pos);
+    } else {
+        max_heapify(heap,pos);
+    }
+    return success;
+}
+
+element removeByHandle(MaxHeap heap, int handle) {
+    int pos=handle_to_pos(heap,handle);
+    if (pos<0) {return NULL;}
+
+    //Moving the last element into the hole, the removed handle ends up among the free ones
+    element removed=heap->array[pos];
+    swap_slots(heap,pos,heap->capacity-1);
+    heap->capacity--;
+    if (pos<heap->capacity) {
+        updateKey(heap,heap->heap_handle[pos]);
+    }
+    return removed;
+}
+
+MaxHeap createMinMaxHeap(char* name, int Max, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc) {
+    MaxHeap heap=createIndexedHeap(name,Max,copyFunc,freeFunc,printFunc,eqlFunc);
+    if (!heap) {return NULL;}
+    heap->kind=minmax_heap;
+    heap->arity=2;
+    return heap;
+}
+
+status convertToMinMaxHeap(MaxHeap heap) {
+    //input validation
+    if (!heap || (heap->kind!=pointer_heap && heap->kind!=minmax_heap)) {return failure;}
+    if (heap->kind==minmax_heap) {return success;}
+
+    //Min-max heaps are always addressable, existing handles keep their numbers
+    if (resize_handles(heap,heap->allocated)!=success) {return memory_error;}
+    heap->kind=minmax_heap;
+    heap->arity=2;
+
+    //Rebuilding bottom-up in O(n), every move goes through swap_slots so the handles follow their elements
+    build_heap(heap);
+    return success;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Finds the position of the smallest element of a min-max heap: the root or one of its two children.
+ * @param heap A pointer to a non-empty min-max MaxHeap.
+ * @return The position of the smallest element.
+ */
+static int min_pos (MaxHeap heap) {
+    if (heap->capacity==1) {return 0;}
+    if (heap->capacity==2 || heap->eqlfunc(heap->array[1],heap->array[2])!=1) {return 1;}
+    return 2;
+}
+
+element TopMinHeap(MaxHeap heap) {
+    //input validation
+    if (!heap || heap->kind!=minmax_heap || heap->capacity==0) {return NULL;}
+    return heap->array[min_pos(heap)];
+}
+
+element PopMinHeap(MaxHeap heap) {
+    //input validation
+    if (!heap || heap->kind!=minmax_heap || heap->capacity==0) {return NULL;}
+    return removeByHandle(heap,heap->heap_handle[min_pos(heap)]);
 }
\ No newline at end of file
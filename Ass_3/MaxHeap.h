@@ -5,13 +5,17 @@
 //Pointer alias for the generic ADT Heap
 typedef struct MaxHeap_s* MaxHeap;
 
+//Pointer alias for a read-only ordered iterator over a MaxHeap
+typedef struct HeapIterator_s* HeapIterator;
+
 /**
  * Creates and initializes a new generic MaxHeap structure.
  * This function allocates memory for the heap structure, the internal array, and
  * performs a deep copy of the heap's name.
  * It also sets up the necessary generic function pointers.
  * @param name A string representing the name/identifier of the heap.
- * @param Max The maximum capacity (num of elements) the heap can hold.
+ * The array starts small and doubles on demand, so Max only limits the number of elements.
+ * @param Max The maximum capacity (num of elements) the heap can hold, or UNBOUNDED_CAPACITY for no limit.
  * @param copyFunc A pointer to a function that performs a deep copy of an element.
  * @param freeFunc A pointer to a function that deallocates memory for an element.
  * @param printFunc A pointer to a function that prints an element.
@@ -20,6 +24,81 @@ typedef struct MaxHeap_s* MaxHeap;
  */
 MaxHeap createHeap(char* name, int Max, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc);
 
+/**
+ * Creates a new MaxHeap whose nodes have 'arity' children instead of 2.
+ * A wider node makes the tree shallower, so a pop touches fewer levels (fewer cache misses)
+ * at the price of more comparisons per level. createHeap uses HEAP_DEFAULT_ARITY (2 unless
+ * overridden at compile time, where any value other than 2, 4 or 8 fails the build).
+ * @param arity Number of children per node: 2, 4 or 8.
+ * The other parameters and the return value are as in createHeap. NULL is also returned for an unsupported arity.
+ */
+MaxHeap createHeapWithArity(char* name, int Max, int arity, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc);
+
+/**
+ * Creates an addressable MaxHeap.
+ * Besides the usual operations, every element of an indexed heap has a handle: a small
+ * integer that keeps referring to the element while it moves inside the heap, until the
+ * element is popped or removed (the number may then be given to a later insertion).
+ * Handles allow updating the key of an element or removing it in O(log n).
+ * The parameters and the return value are as in createHeap.
+ */
+MaxHeap createIndexedHeap(char* name, int Max, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc);
+
+/**
+ * Creates a double-ended MaxHeap (a min-max heap) that can also return its smallest element in O(1)
+ * and remove it in O(log n), through TopMinHeap and PopMinHeap. Min-max heaps are always addressable,
+ * like the heaps of createIndexedHeap. The parameters and the return value are as in createHeap.
+ */
+MaxHeap createMinMaxHeap(char* name, int Max, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc);
+
+/**
+ * Turns an existing pointer heap (createHeap, createHeapWithArity or createIndexedHeap) into a min-max heap
+ * in O(n), keeping its elements and the handles of an indexed heap.
+ * @param heap A pointer to the MaxHeap.
+ * @return success if the heap is now a min-max heap, memory_error if an allocation failed,
+ * or failure if the heap is NULL or uses inline or bucket storage.
+ */
+status convertToMinMaxHeap(MaxHeap heap);
+
+/**
+ * Creates a MaxHeap that stores fixed-size records by value instead of element pointers.
+ * Every record is copied byte by byte into one contiguous block and ordered by the integer
+ * key returned by getKey, kept in a separate contiguous array, so comparisons never follow
+ * pointers. Records are plain values: the heap never calls a copy or free function on them.
+ * For an inline heap:
+ * insertToHeap, insertToHeapOwned and heapifyBulk copy elemSize bytes from each given element, the caller keeps it.
+ * TopMaxHeap and iterators return the address of a record inside the heap, valid until the heap changes.
+ * PopMaxHeap returns a malloc'ed copy of the record (release it with free), popMaxHeapInto avoids that allocation.
+ * @param name A string representing the name/identifier of the heap.
+ * @param Max The maximum capacity of the heap, or UNBOUNDED_CAPACITY for no limit.
+ * @param elemSize The size in bytes of every record.
+ * @param getKey A pointer to a function that returns the key of a record (larger key = higher priority).
+ * @param printFunc A pointer to a function that prints a record.
+ * @return A pointer to the newly created MaxHeap, or NULL if any input is invalid or allocation failed.
+ */
+MaxHeap createInlineHeap(char* name, int Max, int elemSize, getKeyFunction getKey, printFunction printFunc);
+
+/**
+ * Creates a MaxHeap backed by a bucket queue instead of a comparison heap.
+ * Elements are ordered by the integer key returned by getKey, which must lie in [minKey, maxKey].
+ * Insertion is O(1) and pop-max is amortized O(1) (plus the scan over empty buckets below the
+ * maximum), so it suits small bounded keys such as attack values. Elements with equal keys come out
+ * in no particular order. A bucket heap has no array order, so getHeapSlot returns NULL for it, and the
+ * functions of the other kinds (the handle functions, popMaxHeapInto, the min-max functions and
+ * convertToMinMaxHeap) fail on it; the rest of the MaxHeap functions work on it as usual.
+ * Inserting an element whose key is out of range returns failure.
+ * @param name A string representing the name/identifier of the heap.
+ * @param Max The maximum capacity of the heap, or UNBOUNDED_CAPACITY for no limit.
+ * @param minKey The smallest key the heap accepts.
+ * @param maxKey The largest key the heap accepts.
+ * @param getKey A pointer to a function that returns the key of an element.
+ * @param copyFunc A pointer to a function that performs a deep copy of an element.
+ * @param freeFunc A pointer to a function that deallocates memory for an element.
+ * @param printFunc A pointer to a function that prints an element.
+ * @return A pointer to the newly created MaxHeap, or NULL if any input is invalid or allocation failed.
+ */
+MaxHeap createBucketHeap(char* name, int Max, int minKey, int maxKey, getKeyFunction getKey, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc);
+
 /**
  * Creates a deep copy of an existing MaxHeap.
  * This function allocates a new MaxHeap as same as the original,
@@ -38,12 +117,12 @@ MaxHeap copyHeap(MaxHeap old);
 status destroyHeap(MaxHeap heap);
 
 /**
-* Prints the heap elements from largest to smallest.
-* This function creates a temporary copy of the heap to extract elements
-* without changing the original heap. It prints each element and frees the temporary copy when finished.
+* Prints the heap elements from largest to smallest, equal elements in the order PopMaxHeap would remove them.
+* This function drains a private copy of the heap's storage (element pointers, or the records of an
+* inline heap), so the heap is not changed and no element is copied.
 * @param heap A pointer to the MaxHeap to be printed.
 * @return success if the heap was printed, memory_error if memory allocation
-* for the temporary copy failed, or failure if the original heap pointer is invalid.
+* for the private copy failed, or failure if the original heap pointer is invalid.
 */
 status printHeap(MaxHeap heap);
 
@@ -56,6 +135,14 @@ status printHeap(MaxHeap heap);
  */
 char* getHeapid(MaxHeap heap);
 
+/**
+ * Returns the heap's name itself, without copying it (see getHeapid for a copy).
+ * The string is still owned by the heap and must not be changed or freed.
+ * @param heap A pointer to the MaxHeap.
+ * @return The name of the heap, or NULL if the heap is NULL.
+ */
+char* getHeapName(MaxHeap heap);
+
 /**
  * Returns the current number of elements in the heap.
  * @param heap A pointer to the MaxHeap.
@@ -71,6 +158,14 @@ int getHeapCurrentSize(MaxHeap heap);
  */
 element PopMaxHeap(MaxHeap heap);
 
+/**
+ * Removes the maximum record of an inline heap, copying it into a buffer supplied by the caller.
+ * @param heap A pointer to a MaxHeap created by createInlineHeap.
+ * @param out A buffer of at least the heap's record size.
+ * @return success if a record was copied, or failure if the heap is empty, NULL or not inline.
+ */
+status popMaxHeapInto(MaxHeap heap, element out);
+
 /**
  * Returns the maximum element from the heap without removing it.
  * The element is still managed by the heap and should not be freed by the user.
@@ -79,6 +174,18 @@ element PopMaxHeap(MaxHeap heap);
  */
 element TopMaxHeap (MaxHeap heap);
 
+/**
+ * Returns the element stored at a position of the heap's array (position 0 holds the maximum).
+ * Reading positions 0..size-1 visits every element once in storage order; handing them in that order
+ * to heapifyBulk on an empty heap of the same kind rebuilds the same layout without moving any element,
+ * and any prefix of that order is itself a valid heap.
+ * The element is still managed by the heap and should not be freed by the user.
+ * @param heap A pointer to the MaxHeap (not a bucket heap, which has no array order).
+ * @param pos A position, 0..size-1.
+ * @return The element, or NULL if the heap is NULL, a bucket heap or pos is out of range.
+ */
+element getHeapSlot(MaxHeap heap, int pos);
+
 /**
  * Inserts a new element into the MaxHeap.
  * The function creates a deep copy of the element and adds it to the heap,
@@ -89,4 +196,194 @@ element TopMaxHeap (MaxHeap heap);
  * memory_error if memory allocation for the copy fails, or failure if the input is NULL.
  */
 status insertToHeap(MaxHeap heap,element elem);
+
+/**
+ * Inserts an element into the MaxHeap without copying it.
+ * The heap takes ownership of the element and will free it when it is destroyed.
+ * @param heap A pointer to the MaxHeap.
+ * @param elem The element to be adopted.
+ * @return success if inserted, failure_fullcapacity if the heap is full,
+ * memory_error if growing the heap failed, or failure if the input is NULL.
+ * On any error the caller still owns the element.
+ */
+status insertToHeapOwned(MaxHeap heap,element elem);
+
+/**
+ * Makes sure the heap has room for at least n elements without further reallocations.
+ * @param heap A pointer to the MaxHeap.
+ * @param n The number of elements to reserve room for.
+ * @return success if the room is available, failure_fullcapacity if n exceeds the heap's
+ * maximum capacity, memory_error if the allocation failed, or failure if the input is invalid.
+ */
+status reserveHeap(MaxHeap heap, int n);
+
+/**
+ * Releases the unused slots of the heap's internal array.
+ * @param heap A pointer to the MaxHeap.
+ * @return success if the array was shrunk, memory_error if the reallocation failed,
+ * or failure if the heap pointer is NULL.
+ */
+status shrinkHeapToFit(MaxHeap heap);
+
+/**
+ * Adds a batch of elements to the heap in O(n + current size).
+ * The heap takes ownership of the elements (no copies are made) and restores the
+ * Max-Heap rules bottom-up once, instead of sifting up every element.
+ * The array itself stays owned by the caller.
+ * @param heap A pointer to the MaxHeap.
+ * @param elems An array of n elements to be adopted by the heap.
+ * @param n The number of elements in the array.
+ * @return success if all elements were added, failure_fullcapacity if they do not fit,
+ * memory_error if growing the heap failed, or failure if the input is invalid.
+ * On any error no element is adopted and the caller still owns all of them.
+ */
+status heapifyBulk(MaxHeap heap, element* elems, int n);
+
+/**
+ * Moves every element of src into dst in O(n + m) by concatenating them and restoring the heap rules once.
+ * No element is copied: dst takes over the elements and src is left empty (its handles become invalid),
+ * while the handles of dst keep referring to their elements.
+ * Inline heaps can only be melded with inline heaps of the same record size; the other kinds mix freely,
+ * as long as a bucket dst accepts the keys of every element of src.
+ * @param dst A pointer to the MaxHeap receiving the elements.
+ * @param src A pointer to the MaxHeap giving them away.
+ * @return success if all elements moved, failure_fullcapacity if they do not fit in dst,
+ * memory_error if an allocation failed, or failure if the heaps are NULL, the same or incompatible.
+ * On any error both heaps keep their elements.
+ */
+status meldHeaps(MaxHeap dst, MaxHeap src);
+
+/**
+ * Creates a new MaxHeap that adopts the given elements, built in O(n).
+ * @param name A string representing the name/identifier of the heap.
+ * @param Max The maximum capacity of the heap, or UNBOUNDED_CAPACITY for no limit.
+ * @param elems An array of n elements to be adopted by the heap.
+ * @param n The number of elements in the array.
+ * @param copyFunc A pointer to a function that performs a deep copy of an element.
+ * @param freeFunc A pointer to a function that deallocates memory for an element.
+ * @param printFunc A pointer to a function that prints an element.
+ * @param eqlFunc A pointer to a function that compares two elements.
+ * @return A pointer to the new MaxHeap, or NULL on error (the elements then stay owned by the caller).
+ */
+MaxHeap buildHeapFromArray(char* name, int Max, element* elems, int n, copyFunction copyFunc, freeFunction freeFunc, printFunction printFunc, equalFunction eqlFunc);
+
+/**
+ * Creates a read-only iterator that visits the heap elements from largest to smallest.
+ * Visiting k elements costs O(k log k) and no element is copied. Equal elements are visited by their
+ * position in the heap's array, which is not always the order PopMaxHeap would remove them in.
+ * The heap must not be modified while the iterator is in use.
+ * @param heap A pointer to the MaxHeap.
+ * @return A pointer to the new iterator, or NULL if the heap is NULL or memory allocation failed.
+ */
+HeapIterator createHeapIterator(MaxHeap heap);
+
+/**
+ * Returns the next largest element of the iterated heap.
+ * The element is still managed by the heap and should not be freed by the user.
+ * @param it A pointer to the iterator.
+ * @return A pointer to the next element, or NULL if all elements were visited,
+ * the iterator is NULL or memory allocation failed.
+ */
+element nextInHeapIterator(HeapIterator it);
+
+/**
+ * Destroys an iterator. The iterated heap is not affected.
+ * @param it A pointer to the iterator.
+ */
+void destroyHeapIterator(HeapIterator it);
+
+/**
+ * Fills out with the k largest elements of the heap, from largest to smallest, in O(k log k).
+ * The elements are still managed by the heap and should not be freed by the user.
+ * @param heap A pointer to the MaxHeap.
+ * @param k The number of elements requested.
+ * @param out An array with room for at least k elements.
+ * @return The number of elements written (less than k if the heap is smaller),
+ * or -1 if the input is invalid or memory allocation failed.
+ */
+int topKMaxHeap(MaxHeap heap, int k, element out[]);
+
+/**
+ * Inserts a deep copy of an element into an indexed heap and returns its handle.
+ * @param heap A pointer to a MaxHeap created by createIndexedHeap.
+ * @param elem The element to be inserted.
+ * @param handle Receives the handle of the inserted element.
+ * @return As insertToHeap, failure is also returned if the heap is not indexed.
+ */
+status insertWithHandle(MaxHeap heap, element elem, int* handle);
+
+/**
+ * Inserts an element into an indexed heap without copying it, and returns its handle.
+ * @param heap A pointer to a MaxHeap created by createIndexedHeap.
+ * @param elem The element to be adopted.
+ * @param handle Receives the handle of the inserted element.
+ * @return As insertToHeapOwned, failure is also returned if the heap is not indexed.
+ */
+status insertOwnedWithHandle(MaxHeap heap, element elem, int* handle);
+
+/**
+ * Returns the element that a handle refers to, the element is still managed by the heap.
+ * @param heap A pointer to an indexed MaxHeap.
+ * @param handle The handle of the element.
+ * @return The element, or NULL if the heap is not indexed or the handle is not in use.
+ */
+element getByHandle(MaxHeap heap, int handle);
+
+/**
+ * Searches an indexed heap for an element matching a key, in O(n) without changing the heap.
+ * @param heap A pointer to an indexed MaxHeap.
+ * @param key The key to search for.
+ * @param match A function that returns 0 when an element matches the key.
+ * @return The handle of a matching element, or -1 if none was found or the input is invalid.
+ */
+int findHandleInHeap(MaxHeap heap, element key, equalFunction match);
+
+/**
+ * Restores the heap rules after the key of an element grew (the element was changed in place).
+ * @param heap A pointer to an indexed MaxHeap.
+ * @param handle The handle of the changed element.
+ * @return success, or failure if the heap is not indexed or the handle is not in use.
+ */
+status increaseKey(MaxHeap heap, int handle);
+
+/**
+ * Restores the heap rules after the key of an element shrank (the element was changed in place).
+ * @param heap A pointer to an indexed MaxHeap.
+ * @param handle The handle of the changed element.
+ * @return success, or failure if the heap is not indexed or the handle is not in use.
+ */
+status decreaseKey(MaxHeap heap, int handle);
+
+/**
+ * Restores the heap rules after the key of an element changed in an unknown direction.
+ * @param heap A pointer to an indexed MaxHeap.
+ * @param handle The handle of the changed element.
+ * @return success, or failure if the heap is not indexed or the handle is not in use.
+ */
+status updateKey(MaxHeap heap, int handle);
+
+/**
+ * Removes an element from an indexed heap in O(log n).
+ * The caller is responsible for freeing the returned element.
+ * @param heap A pointer to an indexed MaxHeap.
+ * @param handle The handle of the element to remove.
+ * @return The removed element, or NULL if the heap is not indexed or the handle is not in use.
+ */
+element removeByHandle(MaxHeap heap, int handle);
+
+/**
+ * Returns the minimum element of a min-max heap without removing it.
+ * The element is still managed by the heap and should not be freed by the user.
+ * @param heap A pointer to a min-max MaxHeap.
+ * @return A pointer to the minimum element, or NULL if the heap is empty, NULL or not a min-max heap.
+ */
+element TopMinHeap(MaxHeap heap);
+
+/**
+ * Removes and returns the minimum element of a min-max heap in O(log n).
+ * The caller is responsible for freeing the returned element.
+ * @param heap A pointer to a min-max MaxHeap.
+ * @return A pointer to the minimum element, or NULL if the heap is empty, NULL or not a min-max heap.
+ */
+element PopMinHeap(MaxHeap heap);
 #endif //ASS_3_MAXHEAP_H
\ No newline at end of file
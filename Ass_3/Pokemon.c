@@ -39,6 +39,7 @@ P_type* create_pokemon_type(char* name){
     pP_type->num_ea_others=0;
     pP_type->ea_me=NULL;
     pP_type->ea_others=NULL;
+    pP_type->category_id=-1;
     return pP_type;
 }
 
@@ -8,12 +8,13 @@
 /**
  * Pokemon_Type struct represent type of pokemon.
  * This structure represents a Pokemon_type.
- * The structure has 6 fields.
+ * The structure has 7 fields.
  * 1. Name - a pointer to a string
  * 2. How many Pokemon of this type exist in the system
  * 3. How many types effective against me exist in the system
  * 4. How many types I am effective against exist in the system
  * 5+6. Pointers to arrays containing pointers to those types from sections 4+3 respectively.
+ * 7. The id of the type's category in the battle system, or -1 until it is assigned
  */
 typedef struct Pokemon_Type {
   char* name;
@@ -22,6 +23,7 @@ typedef struct Pokemon_Type {
   int num_ea_others;
   struct Pokemon_Type** ea_me;
   struct Pokemon_Type** ea_others;
+  int category_id;
 } P_type;
 
 /**
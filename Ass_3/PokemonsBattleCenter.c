@@ -1,11 +1,23 @@
+//POSIX interfaces: mmap, clock_gettime and the nanosecond times of stat
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "BattleByCategory.h"
 #include "LinkedList.h"
 #include "Pokemon.h"
 
+//Journaled changes are written and synced to disk in groups of this many records (and on exit),
+//so a crash loses at most the last JOURNAL_GROUP_COMMIT-1 changes made in the menu
+#define JOURNAL_GROUP_COMMIT 8
+
 /**
  * A function that receives an array of pointers to Pokémon types and searches for a specific type by its name.
  * @param type_set An array of pointers to Pokémon types
@@ -100,33 +112,239 @@ static status add_to_ea_lists(P_type** pSet_type, char* buffer, int num_of_types
 }
 
 /**
- * Creates a Pokémon based on the data in the received string., and puts it in the battle system.
- * @param b A pointer to the Battle system.
- * @param buffer A string with Pokemon details separated by commas.
+ * Pokemons read from the data file that were not handed to the battle system yet.
+ * The loader collects all of them and inserts them in one bulk operation.
+ */
+typedef struct Poke_Batch {
+    element* pokes;
+    int size;
+    int slots;
+} PokeBatch;
+
+/**
+ * The data file mapped into memory and read line by line in a single pass.
+ * The mapping is private, so lines and fields are cut into strings in place: nothing is copied and the file never changes.
+ */
+typedef struct Data_File {
+    char* data;
+    size_t size;
+    size_t pos;
+    char* last_line;
+    bool memory_problem;
+} DataFile;
+
+/**
+ * Opens the data file and maps it into memory.
+ * @param df The data file to fill.
+ * @param file The data file path.
+ * @return true if the file is open, false if it could not be opened or mapped.
+ */
+static bool open_data_file(DataFile* df, char* file) {
+    int fd = open(file,O_RDONLY);
+    if (fd<0) {return false;}
+    struct stat info;
+    if (fstat(fd,&info)!=0) {
+        close(fd);
+        return false;
+    }
+    df->data=NULL;
+    df->size=info.st_size;
+    df->pos=0;
+    df->last_line=NULL;
+    df->memory_problem=false;
+    if (df->size>0) {
+        df->data=(char*)mmap(NULL,df->size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);
+        if (df->data==MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+    }
+    close(fd);
+    return true;
+}
+
+/**
+ * Returns the next line of the data file as a string, without its line break (a line ends at its first '\r' or '\n').
+ * Lines have no length limit.
+ * @param df The data file.
+ * @param len Set to the length of the line.
+ * @return The line, valid until the data file is closed, or NULL at the end of the file (or if memory ran out,
+ * which sets memory_problem).
+ */
+static char* next_line(DataFile* df, size_t* len) {
+    if (df->pos>=df->size) {return NULL;}
+    char* start = df->data+df->pos;
+    size_t rest = df->size-df->pos;
+    char* end = memchr(start,'\n',rest);
+    size_t n;
+    if (end) {
+        n = end-start;
+        df->pos += n+1;
+    } else {
+        //The last line has no line break to cut it in place, so it is copied once
+        free(df->last_line);
+        df->last_line = (char*)malloc(rest+1);
+        if (df->last_line==NULL) {
+            df->memory_problem=true;
+            return NULL;
+        }
+        memcpy(df->last_line,start,rest);
+        start = df->last_line;
+        n = rest;
+        df->pos = df->size;
+    }
+    char* cr = memchr(start,'\r',n);
+    if (cr) {n = cr-start;}
+    start[n]='\0';
+    *len=n;
+    return start;
+}
+
+/**
+ * Unmaps the data file.
+ * @param df The data file.
+ */
+static void close_data_file(DataFile* df) {
+    if (df->data) {munmap(df->data,df->size);}
+    free(df->last_line);
+}
+
+/**
+ * Cuts the next comma separated field of a line in place.
+ * @param cursor The position of the field, moved to the next field (NULL after the last one).
+ * @param end The end of the line.
+ * @return The field as a string, or NULL if the line has no more fields.
+ */
+static char* next_field(char** cursor, char* end) {
+    char* field = *cursor;
+    if (field==NULL) {return NULL;}
+    char* comma = memchr(field,',',end-field);
+    if (comma) {
+        *comma='\0';
+        *cursor=comma+1;
+    } else {
+        *cursor=NULL;
+    }
+    return field;
+}
+
+/**
+ * Parses the integer at the start of a string, like atoi (leading spaces and a sign are allowed,
+ * parsing stops at the first other character), without its locale handling.
+ * @param str The string.
+ * @return The integer, or 0 if the string does not start with one.
+ */
+static int parse_int(const char* str) {
+    while (*str==' ' || *str=='\t') {str++;}
+    bool negative = *str=='-';
+    if (*str=='-' || *str=='+') {str++;}
+    long value=0;
+    while (*str>='0' && *str<='9' && value<=2147483648L) {
+        value = value*10+(*str-'0');
+        str++;
+    }
+    if (negative) {value=-value;}
+    if (value>2147483647L) {return 2147483647;}
+    if (value<-2147483647L-1) {return -2147483647-1;}
+    return (int)value;
+}
+
+/**
+ * Parses the decimal number at the start of a string, like atof. Plain decimals with up to 15 digits
+ * (all the heights and weights of a data file) are read as an integer divided by an exact power of ten,
+ * which gives the same correctly rounded double as strtod; anything else is left to strtod.
+ * @param str The string.
+ * @return The number, or 0 if the string does not start with one.
+ */
+static double parse_double(const char* str) {
+    static const double powers[]={1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15};
+    const char* p = str;
+    while (*p==' ' || *p=='\t') {p++;}
+    bool negative = *p=='-';
+    if (*p=='-' || *p=='+') {p++;}
+    long long mantissa=0;
+    int digits=0;
+    int decimals=0;
+    while (*p>='0' && *p<='9') {
+        mantissa = mantissa*10+(*p-'0');
+        digits++;
+        p++;
+        if (digits>15) {return strtod(str,NULL);}
+    }
+    if (*p=='.') {
+        p++;
+        while (*p>='0' && *p<='9') {
+            mantissa = mantissa*10+(*p-'0');
+            digits++;
+            decimals++;
+            p++;
+            if (digits>15) {return strtod(str,NULL);}
+        }
+    }
+    if (*p=='e' || *p=='E' || digits==0) {return strtod(str,NULL);}
+    double value = (double)mantissa/powers[decimals];
+    return negative ? -value : value;
+}
+
+/**
+ * Creates a Pokémon based on a line of the data file, and adds it to the loading batch.
+ * The fields are cut in place, the strings are only copied once, into the new Pokemon.
+ * @param batch A pointer to the batch of Pokemons waiting to be inserted to the battle system.
+ * @param line A line with Pokemon details separated by commas (name,species,height,weight,attack,type).
+ * @param len The length of the line.
  * @param num_of_types The number of different Pokemon types available.
  * @param pSet_type An array of all the Pokemon types.
- * @return success if added, memory_error if creation failed, failure_fullcapacity
- * if the category is full, or failure if the input is wrong.
+ * @return success if added, memory_error if creation failed, or failure if the input is wrong.
  */
-static status load_poke_to_battle(Battle b,char* buffer, int num_of_types, P_type** pSet_type) {
-    if (!b || !buffer) {return failure;}
-
-    char* name = strtok(buffer,",");
-    char* species = strtok(NULL,",");
-    double height = atof(strtok(NULL,","));
-    double weight = atof(strtok(NULL,","));
-    int atk = atoi(strtok(NULL,","));
-    char* type_name = strtok(NULL,",");
+static status load_poke_to_batch(PokeBatch* batch, char* line, size_t len, int num_of_types, P_type** pSet_type) {
+    if (!batch || !line) {return failure;}
+
+    char* end = line+len;
+    char* cursor = line;
+    char* name = next_field(&cursor,end);
+    char* species = next_field(&cursor,end);
+    char* height_field = next_field(&cursor,end);
+    char* weight_field = next_field(&cursor,end);
+    char* atk_field = next_field(&cursor,end);
+    char* type_name = next_field(&cursor,end);
+    if (type_name==NULL) {return failure;}
+    double height = parse_double(height_field);
+    double weight = parse_double(weight_field);
+    int atk = parse_int(atk_field);
 
     P_type* ptype = find_type_pointer(pSet_type,num_of_types,type_name);
     if (ptype==NULL) {return failure;}
 
+    //Doubling the batch array when it is full
+    if (batch->size==batch->slots) {
+        int slots = batch->slots>0 ? batch->slots*2 : 64;
+        element* temp = (element*)realloc(batch->pokes,slots*sizeof(element));
+        if (temp==NULL) {return memory_error;}
+        batch->pokes=temp;
+        batch->slots=slots;
+    }
+
     Poke* pPoke = create_pokemon(ptype,name,species,height,weight,atk);
     if (pPoke==NULL) {return memory_error;}
 
-    status insert_st = insertObject(b,pPoke);
-    free_pokemon(pPoke);
-    return insert_st;
+    batch->pokes[batch->size]=pPoke;
+    batch->size++;
+    return success;
+}
+
+/**
+ * Memory deallocation function.
+ * Frees the Pokemons still owned by the batch and the batch array itself.
+ * @param batch A pointer to the batch of Pokemons.
+ */
+static void free_batch(PokeBatch* batch) {
+    for (int i=0; i<batch->size; i++) {
+        free_pokemon((Poke*)batch->pokes[i]);
+    }
+    free(batch->pokes);
+    batch->pokes=NULL;
+    batch->size=0;
+    batch->slots=0;
 }
 
 /**
@@ -177,8 +395,9 @@ static Poke* user_create_poke(P_type* ptype) {
  * @param b A pointer to the Battle system.
  * @param type_set The array of all existing Pokemon types.
  * @param num_of_types The total number of available types.
+ * @param journal The journal recording the removal, or NULL if changes are not journaled.
  */
-static void remove_strongest_poke(Battle b, P_type** type_set, int num_of_types) {
+static void remove_strongest_poke(Battle b, P_type** type_set, int num_of_types, BattleJournal journal) {
     if (!type_set || num_of_types<0) {return;}
 
     //get type name from user
@@ -193,11 +412,16 @@ static void remove_strongest_poke(Battle b, P_type** type_set, int num_of_types)
         printf("Type name doesn't exist.\n");
         return;
     }
-    Poke* strongest = removeMaxByCategory(b,ptype->name);
-    if (!strongest) {
+    if (getNumberOfObjectsInCategory(b,ptype->name)==0) {
         printf("There is no Pokemon to remove.\n");
         return;
     }
+    //The removal is journaled before it is made, a removal that cannot be journaled is not made
+    if (journal && journalRemoveMax(journal,ptype->category_id)!=success) {
+        printf("The removal could not be journaled.\n");
+        return;
+    }
+    Poke* strongest = removeMaxByCategory(b,ptype->name);
     printf("The strongest Pokemon was removed:\n");
     print_pokemon(strongest);
     free_pokemon(strongest);
@@ -278,6 +502,16 @@ static status big_fight(Battle b, P_type** type_set, int num_of_types) {
     return success;
 }
 
+/**
+ * Matches a Pokemon by identity, to find one specific Pokemon in the battle system.
+ * @param elem The generic element (Poke) in the battle system.
+ * @param key The generic element (Poke) to find.
+ * @return 0 if both are the same Pokemon, 1 otherwise.
+ */
+static int same_pokemon(element elem, element key) {
+    return elem==key ? 0 : 1;
+}
+
 /**
  * Gets Pokemon details from the user and adds the new Pokemon to the battle system.
  * The function checks if there is enough space, then creates
@@ -285,11 +519,12 @@ static status big_fight(Battle b, P_type** type_set, int num_of_types) {
  * @param b A pointer to the Battle system.
  * @param type_set The array of all existing Pokemon types.
  * @param num_of_types The total number of types in the system.
- * @param max_capacity The maximum number of Pokemons allowed per category.
+ * @param max_capacity The maximum number of Pokemons allowed per category, or UNBOUNDED_CAPACITY for no limit.
+ * @param journal The journal recording the insertion, or NULL if changes are not journaled.
  * @return success if the Pokemon was added, memory_error if creation failed,
  * failure_fullcapacity if the category is full, or failure for invalid input.
  */
-static status insert_pokemon_to_battle(Battle b, P_type** type_set, int num_of_types, int max_capacity) {
+static status insert_pokemon_to_battle(Battle b, P_type** type_set, int num_of_types, int max_capacity, BattleJournal journal) {
     //input validation
     if (!b || !type_set || num_of_types<0) {return failure;}
 
@@ -306,7 +541,7 @@ static status insert_pokemon_to_battle(Battle b, P_type** type_set, int num_of_t
         return failure;
     }
     //check if there is enough place to insert more pokemons of this type.
-    if (getNumberOfObjectsInCategory(b,ptype->name)>=max_capacity) {
+    if (max_capacity!=UNBOUNDED_CAPACITY && getNumberOfObjectsInCategory(b,ptype->name)>=max_capacity) {
         printf("Type at full capacity.\n");
         return failure_fullcapacity;
     }
@@ -314,12 +549,20 @@ static status insert_pokemon_to_battle(Battle b, P_type** type_set, int num_of_t
     Poke* pNew_Poke = user_create_poke(ptype);
     if (pNew_Poke==NULL) {return memory_error;}
 
-    if (insertObject(b,pNew_Poke)==success) {
-        printf("The Pokemon was successfully added.\n");
-        print_pokemon(pNew_Poke);
+    //The battle system adopts New_Poke on success, otherwise it is still ours to free.
+    if (insertObjectOwned(b,pNew_Poke)!=success) {
+        free_pokemon(pNew_Poke);
+        return success;
     }
-    //free of New_Poke because the fact that insert create a copy of him.
-    free_pokemon(pNew_Poke);
+    //Only an insertion that was made is journaled, and one that cannot be journaled is taken back
+    status st = journal ? journalInsert(journal,pNew_Poke) : success;
+    if (st!=success) {
+        printf("The insertion could not be journaled.\n");
+        free_pokemon(removeObjectByKey(b,ptype->name,pNew_Poke,same_pokemon));
+        return st;
+    }
+    printf("The Pokemon was successfully added.\n");
+    print_pokemon(pNew_Poke);
     return success;
 }
 
@@ -398,6 +641,80 @@ static char* getcategory(element elem) {
     return ((Poke*)elem)->type->name;
 }
 
+/**
+ * This function returns the category id of the Pokemon's type, resolved once when the types were created,
+ * so the battle system finds the category without comparing names.
+ * @param elem The generic element (Poke) to get the category id from.
+ * @return The category id, or -1 if the input is invalid.
+ */
+static int getcategoryid(element elem) {
+    if (!elem) {return -1;}
+    return ((Poke*)elem)->type->category_id;
+}
+
+/**
+ * This function returns the attack power of a Pokemon, which together with its type decides every fight it has,
+ * so the battle system can remember fights by (type, attack).
+ * @param elem The generic element (Poke) to get the attack from.
+ * @return The attack power, or 0 if the input is invalid.
+ */
+static int getattackkey(element elem) {
+    if (!elem) {return 0;}
+    return ((Poke*)elem)->bio_info->atk;
+}
+
+/**
+ * Auxiliary type. The Pokemon types of the system, as the context of type_relation.
+ */
+typedef struct TypeSet {
+    P_type** types;
+    int size;
+} TypeSet;
+
+/**
+ * Finds the type whose battle category has the given id.
+ * @param set The Pokemon types.
+ * @param id The category id.
+ * @return The type, or NULL if no type has this id.
+ */
+static P_type* type_by_id(TypeSet* set, int id) {
+    for (int i=0; i<set->size; i++) {
+        if (set->types[i]->category_id==id) {return set->types[i];}
+    }
+    return NULL;
+}
+
+/**
+ * Auxiliary function for self use only.
+ * Checks whether a type appears in an array of types.
+ * @return true if it does, otherwise false.
+ */
+static bool type_in(P_type** arr, int size, P_type* type) {
+    for (int i=0; i<size; i++) {
+        if (arr[i]==type) {return true;}
+    }
+    return false;
+}
+
+/**
+ * Returns the effectiveness relation between a candidate type and a challenger type, as used by getAttack:
+ * bit 0 is set when the candidate's attack drops against the challenger, bit 1 when the challenger's drops.
+ * Within one relation getAttack only depends on the two attack values, which lets the battle system index fights.
+ * @param categoryId The category id of the candidate's type.
+ * @param challengerClass The category id of the challenger's type.
+ * @param ctx The TypeSet of the system.
+ * @return The relation, 0 to 3.
+ */
+static int type_relation(int categoryId, int challengerClass, element ctx) {
+    P_type* mine=type_by_id((TypeSet*)ctx,categoryId);
+    P_type* other=type_by_id((TypeSet*)ctx,challengerClass);
+    if (!mine || !other) {return 0;}
+    int relation=0;
+    if (type_in(mine->ea_me,mine->num_ea_me,other) || type_in(other->ea_others,other->num_ea_others,mine)) {relation|=1;}
+    if (type_in(mine->ea_others,mine->num_ea_others,other) || type_in(other->ea_me,other->num_ea_me,mine)) {relation|=2;}
+    return relation;
+}
+
 /**
  * Calculates the modified attack values for two Pokemons during a fight.
  * This function checks the type advantages and disadvantages of both Pokemons,
@@ -455,6 +772,193 @@ static int getAttack(element elem1,element elem2, int* atk1,int* atk2){
     return temp_atk1-temp_atk2;
 }
 
+/**
+ * The fixed part of a Pokemon in a snapshot, followed by its name and species strings (with their '\0').
+ * The type is stored as its category id, which is turned back into a type pointer on loading.
+ */
+typedef struct Poke_Record {
+    double height;
+    double weight;
+    int atk;
+    int type_id;
+    int name_size;
+    int species_size;
+} PokeRecord;
+
+/**
+ * Writes a Pokemon as a PokeRecord and its strings, matching the generic serializeFunction signature.
+ * @param elem The generic element (Poke) to write.
+ * @param buffer The buffer to write into.
+ * @param size The size of the buffer.
+ * @param ctx Unused.
+ * @return The number of bytes the Pokemon needs (nothing is written if it exceeds size), or -1 if the input is invalid.
+ */
+static int serialize_pokemon(element elem, char* buffer, int size, element ctx) {
+    (void)ctx;
+    if (!elem || !buffer) {return -1;}
+    Poke* poke=(Poke*)elem;
+    PokeRecord record={poke->bio_info->height,poke->bio_info->weight,poke->bio_info->atk,poke->type->category_id,
+        (int)strlen(poke->pokename)+1,(int)strlen(poke->species)+1};
+    int needed=(int)sizeof(record)+record.name_size+record.species_size;
+    if (needed>size) {return needed;}
+    memcpy(buffer,&record,sizeof(record));
+    memcpy(buffer+sizeof(record),poke->pokename,record.name_size);
+    memcpy(buffer+sizeof(record)+record.name_size,poke->species,record.species_size);
+    return needed;
+}
+
+/**
+ * Creates a Pokemon from the bytes of serialize_pokemon, matching the generic deserializeFunction signature.
+ * @param buffer The bytes of the Pokemon.
+ * @param size The number of bytes.
+ * @param ctx A pointer to the TypeSet, whose types are indexed by category id.
+ * @return The new Pokemon, or NULL if the bytes are invalid or memory allocation failed.
+ */
+static element deserialize_pokemon(char* buffer, int size, element ctx) {
+    TypeSet* set=(TypeSet*)ctx;
+    if (!buffer || !set || size<(int)sizeof(PokeRecord)) {return NULL;}
+    PokeRecord record;
+    memcpy(&record,buffer,sizeof(record));
+    if (record.type_id<0 || record.type_id>=set->size || record.name_size<1 || record.species_size<1
+        || (int)sizeof(record)+record.name_size+record.species_size!=size) {return NULL;}
+    char* name=buffer+sizeof(record);
+    char* species=name+record.name_size;
+    if (name[record.name_size-1]!='\0' || species[record.species_size-1]!='\0') {return NULL;}
+    return create_pokemon(set->types[record.type_id],name,species,record.height,record.weight,record.atk);
+}
+
+/**
+ * Builds the meta part of a snapshot: the capacity and number of types it was made with, the generation of the
+ * journal that continues it, then for every type (in category id order) the sizes of its two effectiveness lists
+ * followed by the category ids in them.
+ * @param pSet_type An array of all the Pokemon types.
+ * @param num_of_types The number of types.
+ * @param max_in_type The capacity of every type.
+ * @param generation The journal generation.
+ * @param size Set to the size of the meta part in bytes.
+ * @return A new int array (the caller frees it), or NULL if memory allocation failed.
+ */
+static int* types_to_meta(P_type** pSet_type, int num_of_types, int max_in_type, int generation, int* size) {
+    int count=3;
+    for (int i=0; i<num_of_types; i++) {
+        count+=2+pSet_type[i]->num_ea_me+pSet_type[i]->num_ea_others;
+    }
+    int* meta=(int*)malloc(sizeof(int)*count);
+    if (!meta) {return NULL;}
+    int idx=0;
+    meta[idx++]=max_in_type;
+    meta[idx++]=num_of_types;
+    meta[idx++]=generation;
+    for (int i=0; i<num_of_types; i++) {
+        meta[idx++]=pSet_type[i]->num_ea_me;
+        meta[idx++]=pSet_type[i]->num_ea_others;
+        for (int j=0; j<pSet_type[i]->num_ea_me; j++) {meta[idx++]=pSet_type[i]->ea_me[j]->category_id;}
+        for (int j=0; j<pSet_type[i]->num_ea_others; j++) {meta[idx++]=pSet_type[i]->ea_others[j]->category_id;}
+    }
+    *size=count*(int)sizeof(int);
+    return meta;
+}
+
+/**
+ * Checks that a snapshot was made with the given number of types and capacity.
+ * @param snap The snapshot.
+ * @param num_of_types The number of types.
+ * @param max_in_type The capacity of every type.
+ * @return true if the snapshot can replace the data file.
+ */
+static bool snapshot_matches(BattleSnapshot snap, int num_of_types, int max_in_type) {
+    int size=0;
+    int* meta=(int*)getSnapshotMeta(snap,&size);
+    if (!meta || size<3*(int)sizeof(int) || meta[0]!=max_in_type || meta[1]!=num_of_types) {return false;}
+
+    //The types are created from the categories string, which must name exactly num_of_types of them
+    int names=1;
+    for (char* c=getSnapshotCategories(snap); *c; c++) {
+        if (*c==',') {names++;}
+    }
+    return names==num_of_types;
+}
+
+/**
+ * Recreates the types and their effectiveness lists from a snapshot, turning the stored category ids back
+ * into type pointers, and then loads the Pokemons of the snapshot into the battle system.
+ * @param b A pointer to the Battle system, created with the categories of the snapshot.
+ * @param snap The snapshot, checked with snapshot_matches.
+ * @param pSet_type An array with room for all the Pokemon types.
+ * @param num_of_types The number of types.
+ * @param generation Set to the generation of the journal that continues the snapshot.
+ * @return success if loaded, memory_error if an allocation failed, or failure if the snapshot is invalid.
+ */
+static status load_snapshot(Battle b, BattleSnapshot snap, P_type** pSet_type, int num_of_types, int* generation) {
+    status st = create_types_set(pSet_type,getSnapshotCategories(snap),num_of_types);
+    if (st!=success) {return st;}
+    for (int i=0; i<num_of_types; i++) {
+        pSet_type[i]->category_id=getCategoryId(b,pSet_type[i]->name);
+    }
+    setCategoryIdFunction(b,getcategoryid);
+
+    int size=0;
+    int* meta=(int*)getSnapshotMeta(snap,&size);
+    int count=size/(int)sizeof(int);
+    *generation=meta[2];
+    int idx=3;
+    for (int i=0; i<num_of_types; i++) {
+        if (idx+2>count) {return failure;}
+        int num_ea_me=meta[idx++];
+        int num_ea_others=meta[idx++];
+        if (num_ea_me<0 || num_ea_others<0 || idx+num_ea_me+num_ea_others>count) {return failure;}
+        for (int j=0; j<num_ea_me+num_ea_others; j++) {
+            int id=meta[idx++];
+            if (id<0 || id>=num_of_types) {return failure;}
+            st = j<num_ea_me ? add_to_ea_me(pSet_type[i],pSet_type[id]) : add_to_ea_others(pSet_type[i],pSet_type[id]);
+            if (st!=success) {return st;}
+        }
+    }
+
+    TypeSet set={pSet_type,num_of_types};
+    st = loadBattleSnapshot(b,snap,deserialize_pokemon,&set);
+    return st==failure_fullcapacity ? success : st;
+}
+
+/**
+ * Checks whether a snapshot file exists and is at least as new as the data file it was made from.
+ * @param snapshot The snapshot file path.
+ * @param file The data file path.
+ * @return true if the snapshot can be used instead of the data file.
+ */
+static bool snapshot_is_fresh(char* snapshot, char* file) {
+    struct stat snap_info;
+    struct stat file_info;
+    if (stat(snapshot,&snap_info)!=0 || stat(file,&file_info)!=0) {return false;}
+    if (snap_info.st_mtim.tv_sec!=file_info.st_mtim.tv_sec) {return snap_info.st_mtim.tv_sec>file_info.st_mtim.tv_sec;}
+    return snap_info.st_mtim.tv_nsec>=file_info.st_mtim.tv_nsec;
+}
+
+/**
+ * Writes the current battle system to the snapshot file as the base of a new journal generation,
+ * then empties the journal, whose records are all part of the new snapshot.
+ * If the program stops between the two steps, the old journal is of an older generation than the
+ * snapshot and is never replayed over it.
+ * @param b A pointer to the Battle system.
+ * @param journal The journal, or NULL to only write the snapshot.
+ * @param snapshot_file The snapshot file path.
+ * @param pSet_type An array of all the Pokemon types.
+ * @param num_of_types The number of types.
+ * @param max_in_type The capacity of every type.
+ * @param generation The generation of the current journal, advanced on success.
+ * @return success if compacted, memory_error if an allocation failed, or failure on an I/O error.
+ */
+static status compact_journal(Battle b, BattleJournal journal, char* snapshot_file, P_type** pSet_type, int num_of_types, int max_in_type, int* generation) {
+    int meta_size=0;
+    int* meta = types_to_meta(pSet_type,num_of_types,max_in_type,*generation+1,&meta_size);
+    if (meta==NULL) {return memory_error;}
+    status st = saveBattleSnapshot(b,snapshot_file,meta,meta_size,serialize_pokemon,NULL);
+    free(meta);
+    if (st!=success) {return st;}
+    *generation+=1;
+    return journal ? resetBattleJournal(journal,*generation) : success;
+}
+
 /**
  * The main entry point of the Pokemon Battle System.
  * This function manages the entire program: it takes the arguments from the cmd,
@@ -463,7 +967,10 @@ static int getAttack(element elem1,element elem2, int* atk1,int* atk2){
  * error handling for memory allocations and file operations.
  * In addition, guarantees that all dynamic memory is freed before the program exits.
  * @param argc Number of command-line arguments.
- * @param argv Array of command-line arguments (num_of_types, max_in_type, file_path).
+ * @param argv Array of command-line arguments (num_of_types, max_in_type, file_path, and optionally snapshot_path:
+ * a binary snapshot used instead of the data file while it is up to date, and rewritten after the data file was read;
+ * the inserts and removals of the menu are then journaled in snapshot_path.journal, replayed on the next start,
+ * and folded into the snapshot by menu option 7).
  * @return 0 on successful execution and clean exit, or 1 if an error (memory or file) occurs.
  */
 int main (int argc, char* argv[]) {
@@ -472,100 +979,211 @@ int main (int argc, char* argv[]) {
     int num_of_types=atoi(argv[1]);
     int max_in_type=atoi(argv[2]);
     char* file=argv[3];
+    char* snapshot_file = argc>4 ? argv[4] : NULL;
 
-    //Opening the file + Initializing a buffer to read the lines + Initializing an appropriate auxiliary flag for easier reading of the file.
-    FILE* pfile = fopen(file,"r");
+    //With POKEMONS_VERBOSE set, the loader reports its throughput on stderr.
+    bool verbose = getenv("POKEMONS_VERBOSE")!=NULL;
+    struct timespec load_start;
+    clock_gettime(CLOCK_MONOTONIC,&load_start);
+
+    //Mapping the data file, it is read line by line in a single pass.
+    DataFile data;
 
     //Check that the file was opened successfully
-    if (pfile==NULL) {
+    if (open_data_file(&data,file)==false) {
         return 1;
     }
 
     char buffer[300];
+    char* line;
+    size_t len;
     bool memory_problem=false;
     bool any_failure=false;
     status st;
-    flagline fline=Types_header;
+    flagline fline=ea;
+    PokeBatch batch={NULL,0,0};
 
     P_type** pSet_type=(P_type**)malloc(num_of_types * sizeof(P_type *));
     if (pSet_type==NULL) {
-        fclose(pfile);
+        close_data_file(&data);
         printf("No memory available.\n");
         return 1;
     }
 
-    //Auxiliary rows to get the row that contains all the tapes to create the structure that contains all the Pokémon
-    char* firstline=fgets(buffer,sizeof(buffer),pfile);
-    if (firstline==NULL) {
-        free(pSet_type);
-        fclose(pfile);
-        return 1;
+    //With a snapshot file, the inserts and removals of the menu are journaled next to it.
+    char* journal_file=NULL;
+    if (snapshot_file) {
+        journal_file=(char*)malloc(strlen(snapshot_file)+sizeof(".journal"));
+        if (journal_file==NULL) {
+            free(pSet_type);
+            close_data_file(&data);
+            printf("No memory available.\n");
+            return 1;
+        }
+        sprintf(journal_file,"%s.journal",snapshot_file);
     }
-    char* types_list=fgets(buffer,sizeof(buffer),pfile);
-    if (types_list==NULL) {
+
+    //The first snapshot is the data file as is, so only a journal of generation 0 continues the data file.
+    //A later journal continues a compacted snapshot, which then has to be loaded even if the data file is newer.
+    int journal_generation = journal_file ? getJournalGeneration(journal_file) : -1;
+    bool needs_snapshot = journal_generation>0;
+
+    //An up to date snapshot made with the same types and capacity replaces reading the data file.
+    BattleSnapshot snap = snapshot_file && (needs_snapshot || snapshot_is_fresh(snapshot_file,file)) ? openBattleSnapshot(snapshot_file) : NULL;
+    if (snap && !snapshot_matches(snap,num_of_types,max_in_type)) {
+        closeBattleSnapshot(snap);
+        snap=NULL;
+    }
+    if (snap==NULL && needs_snapshot) {
+        printf("The journal continues a snapshot that cannot be loaded.\n");
+        free(journal_file);
         free(pSet_type);
-        fclose(pfile);
+        close_data_file(&data);
         return 1;
     }
-
-    //Replaces the last character with \0 so that we can read each line as a 'regular' string for create battle.
-    types_list[strcspn(types_list,"\r\n")]='\0';
+    bool from_snapshot = snap!=NULL;
+    int generation=-1;
+
+    //The row that contains all the types, to create the structure that contains all the Pokémon.
+    //It comes from the snapshot, or from the data file after skipping the TYPES header.
+    char* types_line;
+    if (snap) {
+        types_line=getSnapshotCategories(snap);
+    } else {
+        //Skipping the TYPES header
+        types_line = next_line(&data,&len)!=NULL ? next_line(&data,&len) : NULL;
+        if (types_line==NULL) {
+            free(journal_file);
+            free(pSet_type);
+            close_data_file(&data);
+            return 1;
+        }
+    }
 
     //Creating a structure for storing Pokémon
-    Battle poke_battle = createBattleByCategory(max_in_type,num_of_types,types_list,equal_pokemons,copy_pokemon,free_pokemonWrap,getcategory,getAttack,print_pokemon_Wrap);
+    Battle poke_battle = createBattleByCategory(max_in_type,num_of_types,types_line,equal_pokemons,copy_pokemon,free_pokemonWrap,getcategory,getAttack,print_pokemon_Wrap);
     if (poke_battle==NULL)
     {
+        closeBattleSnapshot(snap);
+        free(journal_file);
         free(pSet_type);
-        fclose(pfile);
+        close_data_file(&data);
         printf("No memory available.\n");
         return 1;
     }
 
-    //reset the file position 'idx' to the beginning of the file, so the next read operation will start from the first line.
-    rewind(pfile);
+    //Loading the types and the Pokemons from the snapshot, the rest of the data file is not read at all.
+    if (from_snapshot) {
+        st = load_snapshot(poke_battle,snap,pSet_type,num_of_types,&generation);
+        if (st==failure){any_failure=true;}
+        if (st==memory_error){memory_problem=true;}
+        closeBattleSnapshot(snap);
+    } else {
+        //Calling a function that creates a new instance of 'Pokémon Type' while checking whether the creation was successful or not.
+        st = create_types_set(pSet_type,types_line,num_of_types);
+        if (st==failure){any_failure=true;}
+        if (st==memory_error){memory_problem=true;}
+        //Interning the types: each type keeps its category id and Pokemons are routed by it.
+        if (st==success) {
+            for (int i=0; i<num_of_types; i++) {
+                pSet_type[i]->category_id=getCategoryId(poke_battle,pSet_type[i]->name);
+            }
+            setCategoryIdFunction(poke_battle,getcategoryid);
+        }
+    }
 
-    //Reading each line separately from the file and saving the information according to the relevant content.
-    while (fgets(buffer,sizeof(buffer),pfile)!=NULL) {
+    //Reading the rest of the lines from the file and saving the information according to the relevant content.
+    while (from_snapshot==false && (line=next_line(&data,&len))!=NULL) {
         if (memory_problem==true || any_failure==true){break;}
-        //Replaces the last character with \0 so that we can read each line as a 'regular' string
-        buffer[strcspn(buffer,"\r\n")]='\0';
+        if (len==0) {continue;}
         switch (fline) {
 
-            case Types_header:
-                //Skips the TYPES header in the data file
-                fline=type_list;
-                break;
-
-            case type_list:
-                //Calling a function that creates a new instance of 'Pokémon Type' while checking whether the creation was successful or not.
-                st = create_types_set(pSet_type,buffer,num_of_types);
-                if (st==failure){any_failure=true;}
-                if (st==memory_error){memory_problem=true;}
-                fline=ea;
-                break;
-
             case ea:
                 //Checking whether we need to move on to the next stage of creating the Pokémon instances themselves.
-                if (strcmp(buffer,"Pokemons")==0) {
+                if (strcmp(line,"Pokemons")==0) {
                     fline=pokemon;
                     break;
                 }
                 //A call to a function that takes care of adding certain types to the corresponding lists of other types.
-                st = add_to_ea_lists(pSet_type,buffer,num_of_types);
+                st = add_to_ea_lists(pSet_type,line,num_of_types);
                 if (st==failure){any_failure=true;}
                 if (st==memory_error){memory_problem=true;}
                 break;
 
             case pokemon:
-                //Creating an instance of a new Pokémon based on the data in the file and adding the pointer that points to it to the appropriate array in the heap.
-                st = load_poke_to_battle(poke_battle,buffer,num_of_types,pSet_type);
+                //Creating an instance of a new Pokémon based on the data in the file and collecting it for the bulk insertion below.
+                st = load_poke_to_batch(&batch,line,len,num_of_types,pSet_type);
                 if (st==failure){any_failure=true;}
                 if (st==memory_error){memory_problem=true;}
         }
     }
+    if (data.memory_problem==true) {memory_problem=true;}
+    int loaded=batch.size;
+
+    //Indexing the fights by type relation, now that all the relations are known.
+    if (memory_problem==false && any_failure==false) {
+        TypeSet set={pSet_type,num_of_types};
+        st = enableFightIndex(poke_battle,getcategoryid,4,type_relation,&set);
+        if (st==failure){any_failure=true;}
+        if (st==memory_error){memory_problem=true;}
+    }
 
-    //string represent the menu
-    char* menu2print = "Please choose one of the following numbers:\n1 : Print all Pokemons by types\n2 : Print all Pokemons types\n3 : Insert Pokemon to battles training camp\n4 : Remove strongest Pokemon by type\n5 : Fight\n6 : Exit\n";
+    //Remembering fights by (type, attack), a repeated challenger costs nothing until a category top changes.
+    if (memory_problem==false && any_failure==false) {
+        st = enableFightCache(poke_battle,getcategoryid,getattackkey,64);
+        if (st==failure){any_failure=true;}
+        if (st==memory_error){memory_problem=true;}
+    }
+
+    //Handing all the Pokemons to the battle system at once, every category heap is built in a single pass.
+    if (memory_problem==false && any_failure==false) {
+        st = insertObjectsBulk(poke_battle,batch.pokes,batch.size);
+        if (st==failure){any_failure=true;}
+        if (st==memory_error){memory_problem=true;}
+        //On success (even if full categories dropped some) the battle system owns the Pokemons.
+        if (st==success || st==failure_fullcapacity) {batch.size=0;}
+    }
+    free_batch(&batch);
+
+    //The data file is not needed anymore, the Pokemons own copies of their strings.
+    close_data_file(&data);
+    if (verbose && from_snapshot==false && memory_problem==false && any_failure==false) {
+        struct timespec load_end;
+        clock_gettime(CLOCK_MONOTONIC,&load_end);
+        double seconds = (load_end.tv_sec-load_start.tv_sec)+(load_end.tv_nsec-load_start.tv_nsec)/1e9;
+        double megabytes = data.size/(1024.0*1024.0);
+        fprintf(stderr,"Loaded %d Pokemons from %s: %.2f MB in %.3f s (%.1f MB/s)\n",
+                loaded,file,megabytes,seconds,seconds>0 ? megabytes/seconds : 0.0);
+    }
+
+    //The journal is replayed on the next start. Over a snapshot only the journal of its generation is replayed.
+    //Over the data file only a journal of generation 0 is replayed, and the result is saved as a new snapshot,
+    //after which the journal starts anew.
+    BattleJournal journal=NULL;
+    TypeSet type_set={pSet_type,num_of_types};
+    if (journal_file && memory_problem==false && any_failure==false) {
+        if (from_snapshot) {
+            st = replayBattleJournal(poke_battle,journal_file,generation,deserialize_pokemon,&type_set);
+        } else {
+            generation = journal_generation;
+            st = replayBattleJournal(poke_battle,journal_file,0,deserialize_pokemon,&type_set);
+            //The snapshot is only a shortcut: failing to write it keeps the journal as it is
+            if (st==success && compact_journal(poke_battle,NULL,snapshot_file,pSet_type,num_of_types,max_in_type,&generation)!=success && generation<0) {
+                generation=0;
+            }
+        }
+        if (st==failure){any_failure=true;}
+        if (st==memory_error){memory_problem=true;}
+        if (st==success) {
+            journal=openBattleJournal(journal_file,generation,JOURNAL_GROUP_COMMIT,serialize_pokemon,NULL);
+            if (journal==NULL) {any_failure=true;}
+        }
+    }
+
+    //string represent the menu, with the compaction command when changes are journaled
+    char* menu2print = journal ? "Please choose one of the following numbers:\n1 : Print all Pokemons by types\n2 : Print all Pokemons types\n3 : Insert Pokemon to battles training camp\n4 : Remove strongest Pokemon by type\n5 : Fight\n6 : Exit\n7 : Compact journal into snapshot\n"
+        : "Please choose one of the following numbers:\n1 : Print all Pokemons by types\n2 : Print all Pokemons types\n3 : Insert Pokemon to battles training camp\n4 : Remove strongest Pokemon by type\n5 : Fight\n6 : Exit\n";
+    char last_option = journal ? '7' : '6';
 
     //flag sign Exit case chosen
     bool exit=false;
@@ -586,7 +1204,7 @@ int main (int argc, char* argv[]) {
         //Input test
         if (strlen(buffer)!=1) {
             input_case = invalid;
-        } else if (buffer[0]>'6'||buffer[0]<'1') {
+        } else if (buffer[0]>last_option||buffer[0]<'1') {
             input_case = invalid;
         } else {input_case = valid;}
 
@@ -605,11 +1223,11 @@ int main (int argc, char* argv[]) {
                 print_all_types(pSet_type,num_of_types);
                 break;
             case 3:
-                st = insert_pokemon_to_battle(poke_battle,pSet_type,num_of_types,max_in_type);
+                st = insert_pokemon_to_battle(poke_battle,pSet_type,num_of_types,max_in_type,journal);
                 if (st==memory_error){memory_problem=true;}
                 break;
             case 4:
-                remove_strongest_poke(poke_battle,pSet_type,num_of_types);
+                remove_strongest_poke(poke_battle,pSet_type,num_of_types,journal);
                 break;
             case 5:
                 st = big_fight(poke_battle,pSet_type,num_of_types);
@@ -618,9 +1236,20 @@ int main (int argc, char* argv[]) {
             case 6:
                 exit=true;
                 break;
+            case 7:
+                st = compact_journal(poke_battle,journal,snapshot_file,pSet_type,num_of_types,max_in_type,&generation);
+                if (st==memory_error){memory_problem=true;}
+                printf(st==success ? "The journal was compacted into the snapshot.\n" : "The journal could not be compacted.\n");
+                break;
         }
     }
 
+    //Writing the journal records still waiting for their group commit
+    if (journal && closeBattleJournal(journal)==failure) {
+        any_failure=true;
+    }
+    free(journal_file);
+
     //Freeing memory allocations from the inside out according to the principle
     if (destroyBattleByCategory(poke_battle)==failure) {
         any_failure=true;
@@ -628,9 +1257,6 @@ int main (int argc, char* argv[]) {
     big_free_types(pSet_type,num_of_types);
     free(pSet_type);
 
-    //Closing the data file
-    fclose(pfile);
-
     //Exiting the program in case of a memory problem
     if (memory_problem==true) {
         printf("No memory available\n");
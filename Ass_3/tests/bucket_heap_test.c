@@ -0,0 +1,62 @@
+//Bucket heaps order elements by a bounded integer key instead of comparing them.
+#include "test_common.h"
+#include "MaxHeap.h"
+
+static void test_bucket_order(void) {
+    MaxHeap heap=createBucketHeap("bucket",UNBOUNDED_CAPACITY,0,100,fighter_key,copy_fighter,free_fighter,print_fighter);
+    CHECK(heap!=NULL);
+    for (int i=0; i<300; i++) {
+        Fighter fighter={"Fire","",(i*41)%101};
+        CHECK(insertToHeap(heap,&fighter)==success);
+    }
+    Fighter out_of_range={"Fire","",101};
+    CHECK(insertToHeap(heap,&out_of_range)==failure);
+    CHECK(getHeapCurrentSize(heap)==300);
+    CHECK(((Fighter*)TopMaxHeap(heap))->attack==100);
+
+    //The iterator and printHeap read the heap without changing it
+    HeapIterator it=createHeapIterator(heap);
+    int count=0, last=100;
+    Fighter* next;
+    while ((next=(Fighter*)nextInHeapIterator(it))!=NULL) {
+        CHECK(next->attack<=last);
+        last=next->attack;
+        count++;
+    }
+    destroyHeapIterator(it);
+    CHECK(count==300);
+    CHECK(printHeap(heap)==success);
+
+    //A bucket heap has no array order, and the functions of the other heap kinds refuse it
+    CHECK(getHeapSlot(heap,0)==NULL);
+    Fighter record={"Fire","",1};
+    CHECK(popMaxHeapInto(heap,&record)==failure);
+    CHECK(insertWithHandle(heap,&record,&count)==failure);
+    CHECK(convertToMinMaxHeap(heap)==failure);
+    CHECK(TopMinHeap(heap)==NULL);
+
+    last=100;
+    Fighter* top;
+    while ((top=(Fighter*)PopMaxHeap(heap))!=NULL) {
+        CHECK(top->attack<=last);
+        last=top->attack;
+        free(top);
+    }
+    destroyHeap(heap);
+}
+
+//A bounded bucket heap rejects inserts beyond its capacity.
+static void test_bucket_capacity(void) {
+    MaxHeap heap=createBucketHeap("bucket",2,0,10,fighter_key,copy_fighter,free_fighter,print_fighter);
+    Fighter fighter={"Fire","",5};
+    CHECK(insertToHeap(heap,&fighter)==success);
+    CHECK(insertToHeap(heap,&fighter)==success);
+    CHECK(insertToHeap(heap,&fighter)==failure_fullcapacity);
+    destroyHeap(heap);
+}
+
+int main(void) {
+    test_bucket_order();
+    test_bucket_capacity();
+    return failed_checks;
+}
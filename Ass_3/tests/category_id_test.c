@@ -0,0 +1,52 @@
+//Interned category ids: names resolve to their position, and the *ById functions match the functions by name.
+#include "test_common.h"
+#include "BattleByCategory.h"
+
+//The id of a fighter's category in the battle below, as a category id function
+static int fighter_category_id(element elem) {
+    char* category=((Fighter*)elem)->category;
+    if (strcmp(category,"Fire")==0) {return 0;}
+    if (strcmp(category,"FireWater")==0) {return 1;}
+    if (strcmp(category,"Water")==0) {return 2;}
+    return -1;
+}
+
+int main(void) {
+    char categories[]="Fire,FireWater,Water";
+    Battle b=createBattleByCategory(3,3,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    CHECK(strcmp(categories,"Fire,FireWater,Water")==0);
+    CHECK(getCategoryId(b,"Fire")==0);
+    CHECK(getCategoryId(b,"FireWater")==1);
+    CHECK(getCategoryId(b,"Water")==2);
+    CHECK(getCategoryId(b,"Fir")==-1);
+    CHECK(getCategoryId(b,"Grass")==-1);
+    CHECK(getCategoryId(b,NULL)==-1);
+
+    Fighter fighter={"Water","Psyduck",48};
+    CHECK(insertObjectById(b,2,&fighter)==success);
+    CHECK(insertObjectById(b,3,&fighter)==failure);
+    CHECK(getNumberOfObjectsInCategory(b,"Water")==1);
+
+    CHECK(setCategoryIdFunction(b,fighter_category_id)==success);
+    Fighter fighters[]={{"FireWater","Volcanion",110},{"Fire","Ponyta",65},{"Fire","Ekans",52}};
+    for (int i=0; i<3; i++) {CHECK(insertObject(b,&fighters[i])==success);}
+    Fighter unknown={"Grass","Oddish",49};
+    CHECK(insertObject(b,&unknown)!=success);
+    CHECK(getNumberOfObjectsInCategory(b,"FireWater")==1);
+    CHECK(getNumberOfObjectsInCategory(b,"Fire")==2);
+    CHECK(getNumberOfObjectsInCategory(b,"Grass")==0);
+
+    element top[3];
+    CHECK(topKByCategory(b,"Fire",3,top)==2);
+    Fighter* strongest=(Fighter*)removeMaxById(b,0);
+    CHECK(strongest!=NULL && strcmp(strongest->name,"Ponyta")==0);
+    free(strongest);
+    CHECK(removeMaxById(b,-1)==NULL);
+    strongest=(Fighter*)removeMaxByCategory(b,"Fire");
+    CHECK(strongest!=NULL && strcmp(strongest->name,"Ekans")==0);
+    free(strongest);
+    CHECK(removeMaxById(b,0)==NULL);
+    destroyBattleByCategory(b);
+    return failed_checks;
+}
@@ -0,0 +1,26 @@
+//forEachCategory visits the category heaps in the order of the categories string.
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+//Appends the size of every visited heap to the string given as context, stopping at an empty heap.
+static bool collect_sizes(element heap, element sizes) {
+    char size[16];
+    snprintf(size,sizeof(size),"%d ",getHeapCurrentSize((MaxHeap)heap));
+    strcat((char*)sizes,size);
+    return getHeapCurrentSize((MaxHeap)heap)>0;
+}
+
+int main(void) {
+    char categories[]="Fire,Water,Grass,Ice";
+    Battle b=createBattleByCategory(10,4,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    Fighter fighters[]={{"Fire","Ponyta",65},{"Water","Psyduck",48},{"Water","Poliwag",48},{"Ice","Swinub",50}};
+    for (int i=0; i<4; i++) {insertObject(b,&fighters[i]);}
+    char sizes[64]="";
+    CHECK(forEachCategory(b,collect_sizes,sizes)==success);
+    CHECK(strcmp(sizes,"1 2 0 ")==0);
+    CHECK(forEachCategory(b,NULL,sizes)==failure);
+    destroyBattleByCategory(b);
+    return failed_checks;
+}
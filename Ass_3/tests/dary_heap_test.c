@@ -0,0 +1,47 @@
+//Heaps of arity 2, 4 and 8 keep the heap order through inserts, bulk inserts and pops.
+#include "test_common.h"
+#include "MaxHeap.h"
+
+//Runs a mix of inserts, bulk inserts and pops on a heap of the given arity and checks every pop.
+static void run_arity(int arity) {
+    MaxHeap heap=createHeapWithArity("dary",UNBOUNDED_CAPACITY,arity,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    CHECK(heap!=NULL);
+    if (heap==NULL) {return;}
+    element batch[100];
+    for (int i=0; i<100; i++) {
+        Fighter fighter={"Fire","",(i*17)%61};
+        CHECK(insertToHeap(heap,&fighter)==success);
+        batch[i]=new_fighter("Fire","",(i*29)%67);
+    }
+    CHECK(heapifyBulk(heap,batch,100)==success);
+
+    //Popping and inserting in turns, so elements sift down and up at every level
+    for (int round=0; round<50; round++) {
+        Fighter* top=(Fighter*)PopMaxHeap(heap);
+        HeapIterator it=createHeapIterator(heap);
+        Fighter* next=(Fighter*)nextInHeapIterator(it);
+        CHECK(top!=NULL && next!=NULL && top->attack>=next->attack);
+        destroyHeapIterator(it);
+        free(top);
+        Fighter fighter={"Fire","",(round*13)%70};
+        CHECK(insertToHeap(heap,&fighter)==success);
+    }
+    CHECK(getHeapCurrentSize(heap)==200);
+
+    int last=1000;
+    Fighter* top;
+    while ((top=(Fighter*)PopMaxHeap(heap))!=NULL) {
+        CHECK(top->attack<=last);
+        last=top->attack;
+        free(top);
+    }
+    destroyHeap(heap);
+}
+
+int main(void) {
+    run_arity(2);
+    run_arity(4);
+    run_arity(8);
+    CHECK(createHeapWithArity("dary",10,3,copy_fighter,free_fighter,print_fighter,compare_fighters)==NULL);
+    return failed_checks;
+}
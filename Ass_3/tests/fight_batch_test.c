@@ -0,0 +1,72 @@
+//fightBatch gives every challenger the fight that fight and fightQuery give it alone, batch after batch.
+#include "test_common.h"
+#include "BattleByCategory.h"
+
+#define CHALLENGERS 1000
+
+static char* category_names[]={"Fire","Water","Grass"};
+
+//Checks a batch result against the element that fight returned for the same challenger.
+static void check_result(FightResult* result, element fought, Fighter* challenger) {
+    if (fought==(element)-1) {
+        CHECK(result->outcome==no_opponent && result->opponent==NULL);
+        return;
+    }
+    CHECK(result->opponent!=NULL);
+    int challenger_attack, opponent_attack;
+    fighter_attack(challenger,result->opponent,&challenger_attack,&opponent_attack);
+    CHECK(result->challengerAttack==challenger_attack && result->opponentAttack==opponent_attack);
+    switch (result->outcome) {
+        case challenger_won:
+            CHECK(result->winner==challenger && fought==challenger);
+            break;
+        case challenger_lost:
+            CHECK(result->winner==result->opponent && fought==result->opponent);
+            break;
+        case fight_draw:
+            CHECK(result->winner==NULL && fought==result->opponent);
+            break;
+        default:
+            CHECK(false);
+    }
+}
+
+int main(void) {
+    char categories[]="Fire,Water,Grass";
+    Battle b=createBattleByCategory(UNBOUNDED_CAPACITY,3,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    static Fighter challengers[CHALLENGERS];
+    static element pointers[CHALLENGERS];
+    static FightResult results[CHALLENGERS];
+    srand(5);
+    for (int i=0; i<CHALLENGERS; i++) {
+        strcpy(challengers[i].category,category_names[rand()%3]);
+        snprintf(challengers[i].name,sizeof(challengers[i].name),"c%d",i);
+        challengers[i].attack=rand()%100;
+        pointers[i]=&challengers[i];
+    }
+
+    //An empty battle has no opponent for anyone, and every later batch runs after the categories changed
+    for (int batch=0; batch<4; batch++) {
+        CHECK(fightBatch(b,pointers,CHALLENGERS,results)==success);
+        for (int i=0; i<CHALLENGERS; i++) {
+            check_result(&results[i],fight(b,pointers[i]),&challengers[i]);
+            FightResult single;
+            CHECK(fightQuery(b,pointers[i],&single)==success);
+            CHECK(single.winner==results[i].winner && single.opponent==results[i].opponent);
+            CHECK(single.challengerAttack==results[i].challengerAttack && single.opponentAttack==results[i].opponentAttack);
+            CHECK(single.outcome==results[i].outcome);
+        }
+        for (int i=0; i<20; i++) {
+            Fighter fighter={"","",rand()%100};
+            strcpy(fighter.category,category_names[rand()%3]);
+            snprintf(fighter.name,sizeof(fighter.name),"b%d_%d",batch,i);
+            insertObject(b,&fighter);
+        }
+        free(removeMaxByCategory(b,category_names[batch%3]));
+    }
+    CHECK(fightBatch(b,pointers,0,results)==success);
+    CHECK(fightBatch(NULL,pointers,1,results)==failure);
+    destroyBattleByCategory(b);
+    return failed_checks;
+}
@@ -0,0 +1,82 @@
+//The fight cache answers repeated challenger profiles exactly as a fresh fight, also right after a top changed.
+#include "test_common.h"
+#include "BattleByCategory.h"
+
+static char* category_names[]={"Fire","Water","Grass"};
+
+static int challenger_class(element elem) {
+    for (int i=0; i<3; i++) {
+        if (strcmp(((Fighter*)elem)->category,category_names[i])==0) {return i;}
+    }
+    return -1;
+}
+
+//The groups of fighter_attack, as in fight_index_test.c
+static int fight_group(int categoryId, int challengerClass, element ctx) {
+    (void)ctx;
+    if (challengerClass==0 && categoryId==1) {return 1;}
+    if (challengerClass==1 && categoryId==0) {return 2;}
+    return 0;
+}
+
+static Battle create_battle(void) {
+    char categories[]="Fire,Water,Grass";
+    return createBattleByCategory(UNBOUNDED_CAPACITY,3,categories,compare_fighters,copy_fighter,free_fighter,
+                                  fighter_category,fighter_attack,print_fighter);
+}
+
+//Two results agree when they have the same outcome and attacks and the opponents have the same name.
+static bool same_result(FightResult* result1, FightResult* result2) {
+    if (result1->outcome!=result2->outcome) {return false;}
+    if ((result1->opponent==NULL)!=(result2->opponent==NULL)) {return false;}
+    if (result1->opponent==NULL) {return true;}
+    return result1->challengerAttack==result2->challengerAttack && result1->opponentAttack==result2->opponentAttack
+           && strcmp(((Fighter*)result1->opponent)->name,((Fighter*)result2->opponent)->name)==0;
+}
+
+int main(void) {
+    Battle plain=create_battle();
+    Battle cached=create_battle();
+    CHECK(enableFightCache(cached,challenger_class,fighter_key,64)==success);
+    CHECK(enableFightIndex(cached,challenger_class,3,fight_group,NULL)==success);
+    CHECK(enableFightCache(cached,NULL,fighter_key,64)==failure);
+
+    //A few profiles fought over and over, while inserts, removals and updates change the tops now and then
+    Fighter challengers[12];
+    for (int i=0; i<12; i++) {
+        strcpy(challengers[i].category,category_names[i%3]);
+        snprintf(challengers[i].name,sizeof(challengers[i].name),"c%d",i);
+        challengers[i].attack=40+i*3;
+    }
+    srand(3);
+    for (int round=0; round<500; round++) {
+        if (round%7==0) {
+            Fighter fighter={"","",rand()%90};
+            strcpy(fighter.category,category_names[rand()%3]);
+            snprintf(fighter.name,sizeof(fighter.name),"f%d",round);
+            insertObject(plain,&fighter);
+            insertObject(cached,&fighter);
+        }
+        if (round%23==0) {
+            free(removeMaxByCategory(plain,category_names[round%3]));
+            free(removeMaxByCategory(cached,category_names[round%3]));
+        }
+        Fighter* challenger=&challengers[rand()%12];
+        FightResult expected, result;
+        CHECK(fightQuery(plain,challenger,&expected)==success);
+        CHECK(fightQuery(cached,challenger,&result)==success);
+        CHECK(same_result(&expected,&result));
+    }
+
+    //Turning the cache off keeps the same answers
+    CHECK(enableFightCache(cached,challenger_class,fighter_key,0)==success);
+    for (int i=0; i<12; i++) {
+        FightResult expected, result;
+        fightQuery(plain,&challengers[i],&expected);
+        fightQuery(cached,&challengers[i],&result);
+        CHECK(same_result(&expected,&result));
+    }
+    destroyBattleByCategory(plain);
+    destroyBattleByCategory(cached);
+    return failed_checks;
+}
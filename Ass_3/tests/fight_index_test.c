@@ -0,0 +1,65 @@
+//The fight index picks the same opponents as scanning every category, also while the categories change.
+#include "test_common.h"
+#include "BattleByCategory.h"
+
+#define CATEGORIES 3
+
+static char* category_names[CATEGORIES]={"Fire","Water","Grass"};
+
+//The class of a challenger is the id of its category.
+static int challenger_class(element elem) {
+    for (int i=0; i<CATEGORIES; i++) {
+        if (strcmp(((Fighter*)elem)->category,category_names[i])==0) {return i;}
+    }
+    return -1;
+}
+
+//The groups follow fighter_attack: 1 when the category is Water for a Fire challenger (the challenger loses 10),
+//2 when it is Fire for a Water challenger (the category loses 10), otherwise 0.
+static int fight_group(int categoryId, int challengerClass, element ctx) {
+    (void)ctx;
+    if (challengerClass==0 && categoryId==1) {return 1;}
+    if (challengerClass==1 && categoryId==0) {return 2;}
+    return 0;
+}
+
+static Battle create_battle(void) {
+    char categories[]="Fire,Water,Grass";
+    return createBattleByCategory(UNBOUNDED_CAPACITY,CATEGORIES,categories,compare_fighters,copy_fighter,free_fighter,
+                                  fighter_category,fighter_attack,print_fighter);
+}
+
+//Two fight results agree when both found no opponent, or both returned the same fighter.
+static bool same_result(element result1, element result2) {
+    if (result1==(element)-1 || result2==(element)-1) {return result1==result2;}
+    if (result1==NULL || result2==NULL) {return result1==result2;}
+    return strcmp(((Fighter*)result1)->name,((Fighter*)result2)->name)==0;
+}
+
+int main(void) {
+    Battle scanned=create_battle();
+    Battle indexed=create_battle();
+    CHECK(enableFightIndex(indexed,challenger_class,3,fight_group,NULL)==success);
+    Fighter challenger={"Fire","Challenger",50};
+    CHECK(same_result(fight(scanned,&challenger),fight(indexed,&challenger)));
+
+    srand(11);
+    for (int round=0; round<400; round++) {
+        Fighter fighter={"","",rand()%80};
+        strcpy(fighter.category,category_names[rand()%CATEGORIES]);
+        snprintf(fighter.name,sizeof(fighter.name),"f%d",round);
+        if (rand()%4==0) {
+            free(removeMaxByCategory(scanned,fighter.category));
+            free(removeMaxByCategory(indexed,fighter.category));
+        } else {
+            CHECK(insertObject(scanned,&fighter)==success);
+            CHECK(insertObject(indexed,&fighter)==success);
+        }
+        strcpy(challenger.category,category_names[rand()%CATEGORIES]);
+        challenger.attack=rand()%80;
+        CHECK(same_result(fight(scanned,&challenger),fight(indexed,&challenger)));
+    }
+    destroyBattleByCategory(scanned);
+    destroyBattleByCategory(indexed);
+    return failed_checks;
+}
@@ -0,0 +1,73 @@
+//Bulk construction: heapifyBulk, buildHeapFromArray and insertObjectsBulk.
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+//Pops the whole heap, checking that it comes out from largest to smallest, and returns how many elements it had.
+static int drain_in_order(MaxHeap heap) {
+    int count=0, last=0;
+    Fighter* top;
+    while ((top=(Fighter*)PopMaxHeap(heap))!=NULL) {
+        CHECK(count==0 || top->attack<=last);
+        last=top->attack;
+        count++;
+        free(top);
+    }
+    return count;
+}
+
+//heapifyBulk adopts a batch on top of elements inserted one by one, buildHeapFromArray starts from a batch.
+static void test_heap_bulk(void) {
+    MaxHeap heap=createHeap("bulk",UNBOUNDED_CAPACITY,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    element batch[300];
+    for (int i=0; i<300; i++) {
+        Fighter fighter={"Fire","",(i*37)%101};
+        CHECK(insertToHeap(heap,&fighter)==success);
+        batch[i]=new_fighter("Fire","",(i*53)%97);
+    }
+    CHECK(heapifyBulk(heap,batch,300)==success);
+    CHECK(getHeapCurrentSize(heap)==600);
+    CHECK(drain_in_order(heap)==600);
+    destroyHeap(heap);
+
+    for (int i=0; i<300; i++) {batch[i]=new_fighter("Fire","",(i*53)%97);}
+    heap=buildHeapFromArray("built",300,batch,300,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    CHECK(heap!=NULL);
+    CHECK(drain_in_order(heap)==300);
+    destroyHeap(heap);
+
+    //A batch that exceeds the capacity is refused as a whole, and the caller keeps its elements.
+    heap=createHeap("small",2,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    for (int i=0; i<3; i++) {batch[i]=new_fighter("Fire","",i);}
+    CHECK(heapifyBulk(heap,batch,3)!=success);
+    CHECK(getHeapCurrentSize(heap)==0);
+    for (int i=0; i<3; i++) {free(batch[i]);}
+    destroyHeap(heap);
+}
+
+//insertObjectsBulk sorts a batch into the categories, freeing what does not fit.
+static void test_battle_bulk(void) {
+    char categories[]="Fire,Water";
+    Battle b=createBattleByCategory(4,2,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    element batch[8];
+    for (int i=0; i<5; i++) {batch[i]=new_fighter("Fire","",10+i);}
+    for (int i=5; i<8; i++) {batch[i]=new_fighter("Water","",20+i);}
+    CHECK(insertObjectsBulk(b,batch,8)==failure_fullcapacity);
+    CHECK(getNumberOfObjectsInCategory(b,"Fire")==4);
+    CHECK(getNumberOfObjectsInCategory(b,"Water")==3);
+    Fighter* strongest=(Fighter*)removeMaxByCategory(b,"Water");
+    CHECK(strongest!=NULL && strongest->attack==27);
+    free(strongest);
+
+    batch[0]=new_fighter("Water","",1);
+    CHECK(insertObjectsBulk(b,batch,1)==success);
+    CHECK(getNumberOfObjectsInCategory(b,"Water")==3);
+    destroyBattleByCategory(b);
+}
+
+int main(void) {
+    test_heap_bulk();
+    test_battle_bulk();
+    return failed_checks;
+}
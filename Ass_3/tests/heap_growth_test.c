@@ -0,0 +1,64 @@
+//Growing heap arrays: bounded and unbounded heaps, reserveHeap, shrinkHeapToFit and unbounded battles.
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+//A bounded heap rejects inserts beyond its capacity, whatever it reserved.
+static void test_bounded_heap(void) {
+    MaxHeap heap=createHeap("bounded",3,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    Fighter fighter={"Fire","Charmander",52};
+    for (int i=0; i<3; i++) {CHECK(insertToHeap(heap,&fighter)==success);}
+    CHECK(insertToHeap(heap,&fighter)==failure_fullcapacity);
+    CHECK(reserveHeap(heap,10)==failure_fullcapacity);
+    CHECK(getHeapCurrentSize(heap)==3);
+    destroyHeap(heap);
+}
+
+//An unbounded heap grows past any initial size and still pops from largest to smallest.
+static void test_unbounded_heap(void) {
+    MaxHeap heap=createHeap("unbounded",UNBOUNDED_CAPACITY,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    CHECK(reserveHeap(heap,100)==success);
+    for (int i=0; i<5000; i++) {
+        Fighter fighter={"Fire","",(i*7919)%1000};
+        CHECK(insertToHeap(heap,&fighter)==success);
+    }
+    CHECK(getHeapCurrentSize(heap)==5000);
+    int last=1000;
+    for (int i=0; i<4990; i++) {
+        Fighter* top=(Fighter*)PopMaxHeap(heap);
+        CHECK(top!=NULL && top->attack<=last);
+        if (top) {last=top->attack;}
+        free(top);
+    }
+    CHECK(shrinkHeapToFit(heap)==success);
+    CHECK(getHeapCurrentSize(heap)==10);
+    Fighter fighter={"Fire","",1};
+    CHECK(insertToHeap(heap,&fighter)==success);
+    CHECK(getHeapCurrentSize(heap)==11);
+    destroyHeap(heap);
+}
+
+//A battle created with UNBOUNDED_CAPACITY accepts any number of elements per category.
+static void test_unbounded_battle(void) {
+    char categories[]="Fire,Water";
+    Battle b=createBattleByCategory(UNBOUNDED_CAPACITY,2,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    CHECK(b!=NULL);
+    for (int i=0; i<1000; i++) {
+        Fighter fighter={"Water","Squirtle",i%60};
+        CHECK(insertObject(b,&fighter)==success);
+    }
+    CHECK(getNumberOfObjectsInCategory(b,"Water")==1000);
+    CHECK(getNumberOfObjectsInCategory(b,"Fire")==0);
+    Fighter* strongest=(Fighter*)removeMaxByCategory(b,"Water");
+    CHECK(strongest!=NULL && strongest->attack==59);
+    free(strongest);
+    destroyBattleByCategory(b);
+}
+
+int main(void) {
+    test_bounded_heap();
+    test_unbounded_heap();
+    test_unbounded_battle();
+    return failed_checks;
+}
@@ -0,0 +1,90 @@
+//Ordered reads without copying: printHeap, the heap iterator, topKMaxHeap and topKByCategory.
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+//Records the names of the heap in the order PopMaxHeap removes them, from a copy of the heap.
+static void pop_order(MaxHeap heap, char* order, int size) {
+    MaxHeap copy=copyHeap(heap);
+    order[0]='\0';
+    Fighter* top;
+    while ((top=(Fighter*)PopMaxHeap(copy))!=NULL) {
+        strncat(order,top->name,size-strlen(order)-2);
+        strcat(order," ");
+        free(top);
+    }
+    destroyHeap(copy);
+}
+
+//printHeap lists equal elements in the order PopMaxHeap removes them, as the printing by copy and pop did.
+static void test_print_equal_keys(void) {
+    MaxHeap heap=createHeap("Fire",10,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    Fighter fighters[]={{"Fire","Charmander",52},{"Fire","Growlithe",52},{"Fire","Ekans",52},{"Fire","Ponyta",65}};
+    for (int i=0; i<4; i++) {insertToHeap(heap,&fighters[i]);}
+    char order[256];
+    pop_order(heap,order,sizeof(order));
+    CHECK(strcmp(order,"Ponyta Growlithe Ekans Charmander ")==0);
+    printed[0]='\0';
+    CHECK(printHeap(heap)==success);
+    CHECK(strcmp(printed,order)==0);
+    CHECK(getHeapCurrentSize(heap)==4);
+    destroyHeap(heap);
+}
+
+//The iterator and topKMaxHeap visit the elements from largest to smallest without changing the heap.
+static void test_iterator(void) {
+    MaxHeap heap=createHeap("heap",UNBOUNDED_CAPACITY,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    for (int i=0; i<200; i++) {
+        Fighter fighter={"Fire","",(i*31)%50};
+        insertToHeap(heap,&fighter);
+    }
+    HeapIterator it=createHeapIterator(heap);
+    CHECK(it!=NULL);
+    int count=0, last=50;
+    Fighter* next;
+    while ((next=(Fighter*)nextInHeapIterator(it))!=NULL) {
+        CHECK(next->attack<=last);
+        last=next->attack;
+        count++;
+    }
+    destroyHeapIterator(it);
+    CHECK(count==200);
+
+    element top[10];
+    int attacks[10];
+    CHECK(topKMaxHeap(heap,10,top)==10);
+    for (int i=0; i<10; i++) {attacks[i]=((Fighter*)top[i])->attack;}
+    for (int i=0; i<10; i++) {
+        Fighter* popped=(Fighter*)PopMaxHeap(heap);
+        CHECK(popped->attack==attacks[i]);
+        free(popped);
+    }
+    CHECK(getHeapCurrentSize(heap)==190);
+    destroyHeap(heap);
+}
+
+//topKByCategory reads the strongest elements of a category, and fewer when the category is smaller.
+static void test_top_k_by_category(void) {
+    char categories[]="Fire,Water";
+    Battle b=createBattleByCategory(10,2,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    for (int i=0; i<5; i++) {
+        Fighter fighter={"Water","",i*10};
+        insertObject(b,&fighter);
+    }
+    element out[10];
+    CHECK(topKByCategory(b,"Water",3,out)==3);
+    CHECK(((Fighter*)out[0])->attack==40 && ((Fighter*)out[2])->attack==20);
+    CHECK(topKByCategory(b,"Water",10,out)==5);
+    CHECK(topKByCategory(b,"Fire",3,out)==0);
+    CHECK(topKByCategory(b,"Grass",3,out)==-1);
+    CHECK(getNumberOfObjectsInCategory(b,"Water")==5);
+    destroyBattleByCategory(b);
+}
+
+int main(void) {
+    test_print_equal_keys();
+    test_iterator();
+    test_top_k_by_category();
+    return failed_checks;
+}
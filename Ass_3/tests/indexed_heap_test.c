@@ -0,0 +1,76 @@
+//Addressable heaps: handles follow their elements, so keys can change and elements can leave in O(log n).
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+static status set_attack(element elem, element arg) {
+    ((Fighter*)elem)->attack=*(int*)arg;
+    return success;
+}
+
+static void test_handles(void) {
+    MaxHeap heap=createIndexedHeap("indexed",UNBOUNDED_CAPACITY,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    int handles[20];
+    for (int i=0; i<20; i++) {
+        Fighter fighter={"Fire","",i*5};
+        snprintf(fighter.name,sizeof(fighter.name),"f%d",i);
+        CHECK(insertWithHandle(heap,&fighter,&handles[i])==success);
+    }
+    //Every handle still refers to its own element after the others moved
+    for (int i=0; i<20; i++) {
+        Fighter* fighter=(Fighter*)getByHandle(heap,handles[i]);
+        CHECK(fighter!=NULL && fighter->attack==i*5);
+    }
+
+    Fighter* weak=(Fighter*)getByHandle(heap,handles[2]);
+    weak->attack=1000;
+    CHECK(increaseKey(heap,handles[2])==success);
+    CHECK(TopMaxHeap(heap)==weak);
+    weak->attack=-1;
+    CHECK(decreaseKey(heap,handles[2])==success);
+    CHECK(((Fighter*)TopMaxHeap(heap))->attack==95);
+    weak->attack=50;
+    CHECK(updateKey(heap,handles[2])==success);
+
+    CHECK(findHandleInHeap(heap,"f7",fighter_named)==handles[7]);
+    Fighter* removed=(Fighter*)removeByHandle(heap,handles[7]);
+    CHECK(removed!=NULL && strcmp(removed->name,"f7")==0);
+    free(removed);
+    CHECK(findHandleInHeap(heap,"f7",fighter_named)==-1);
+    CHECK(getHeapCurrentSize(heap)==19);
+
+    int last=1000;
+    Fighter* top;
+    while ((top=(Fighter*)PopMaxHeap(heap))!=NULL) {
+        CHECK(top->attack<=last);
+        last=top->attack;
+        free(top);
+    }
+    destroyHeap(heap);
+}
+
+//The battle finds an element by key to remove it or change its attack.
+static void test_battle_by_key(void) {
+    char categories[]="Fire,Water";
+    Battle b=createBattleByCategory(10,2,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    Fighter fighters[]={{"Fire","Charmander",52},{"Fire","Growlithe",52},{"Fire","Ponyta",65}};
+    for (int i=0; i<3; i++) {insertObject(b,&fighters[i]);}
+    int attack=70;
+    CHECK(updateObjectByKey(b,"Fire","Charmander",fighter_named,set_attack,&attack)==success);
+    Fighter* removed=(Fighter*)removeObjectByKey(b,"Fire","Ponyta",fighter_named);
+    CHECK(removed!=NULL && removed->attack==65);
+    free(removed);
+    CHECK(removeObjectByKey(b,"Fire","Ponyta",fighter_named)==NULL);
+    Fighter* strongest=(Fighter*)removeMaxByCategory(b,"Fire");
+    CHECK(strongest!=NULL && strcmp(strongest->name,"Charmander")==0);
+    free(strongest);
+    CHECK(getNumberOfObjectsInCategory(b,"Fire")==1);
+    destroyBattleByCategory(b);
+}
+
+int main(void) {
+    test_handles();
+    test_battle_by_key();
+    return failed_checks;
+}
@@ -0,0 +1,59 @@
+//Inline heaps store fixed-size records by value, ordered by an integer key.
+#include "test_common.h"
+#include "MaxHeap.h"
+
+static void test_inline_records(void) {
+    MaxHeap heap=createInlineHeap("inline",UNBOUNDED_CAPACITY,sizeof(Fighter),fighter_key,print_fighter);
+    CHECK(heap!=NULL);
+    //The heap copies the record, the caller's variable can change afterwards
+    Fighter fighter={"Fire","Ponyta",65};
+    CHECK(insertToHeap(heap,&fighter)==success);
+    fighter.attack=1;
+    CHECK(((Fighter*)TopMaxHeap(heap))->attack==65);
+
+    Fighter batch[50];
+    element pointers[50];
+    for (int i=0; i<50; i++) {
+        batch[i]=fighter;
+        batch[i].attack=(i*23)%60;
+        pointers[i]=&batch[i];
+    }
+    CHECK(heapifyBulk(heap,pointers,50)==success);
+    CHECK(getHeapCurrentSize(heap)==51);
+
+    Fighter* popped=(Fighter*)PopMaxHeap(heap);
+    CHECK(popped!=NULL && popped->attack==65 && strcmp(popped->name,"Ponyta")==0);
+    free(popped);
+
+    Fighter out;
+    int last=100;
+    while (popMaxHeapInto(heap,&out)==success) {
+        CHECK(out.attack<=last);
+        last=out.attack;
+    }
+    CHECK(getHeapCurrentSize(heap)==0);
+    destroyHeap(heap);
+}
+
+//printHeap lists records with equal keys in the order PopMaxHeap removes them.
+static void test_inline_print(void) {
+    MaxHeap heap=createInlineHeap("Fire",10,sizeof(Fighter),fighter_key,print_fighter);
+    Fighter fighters[]={{"Fire","Charmander",52},{"Fire","Growlithe",52},{"Fire","Ekans",52},{"Fire","Ponyta",65}};
+    for (int i=0; i<4; i++) {insertToHeap(heap,&fighters[i]);}
+    printed[0]='\0';
+    CHECK(printHeap(heap)==success);
+    char order[256]="";
+    Fighter out;
+    while (popMaxHeapInto(heap,&out)==success) {
+        strcat(order,out.name);
+        strcat(order," ");
+    }
+    CHECK(strcmp(printed,order)==0);
+    destroyHeap(heap);
+}
+
+int main(void) {
+    test_inline_records();
+    test_inline_print();
+    return failed_checks;
+}
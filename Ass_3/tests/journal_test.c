@@ -0,0 +1,97 @@
+//Journals: replaying the synced records rebuilds the battle, pending and torn records are lost.
+#include <unistd.h>
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+static int serialize_fighter(element elem, char* buffer, int size, element ctx) {
+    (void)ctx;
+    if (size>=(int)sizeof(Fighter)) {memcpy(buffer,elem,sizeof(Fighter));}
+    return sizeof(Fighter);
+}
+
+static element deserialize_fighter(char* buffer, int size, element ctx) {
+    (void)ctx;
+    if (size!=(int)sizeof(Fighter)) {return NULL;}
+    return copy_fighter(buffer);
+}
+
+static bool print_category(element heap, element ctx) {
+    (void)ctx;
+    printHeap((MaxHeap)heap);
+    strcat(printed,"| ");
+    return true;
+}
+
+static Battle create_battle(void) {
+    char categories[]="Fire,Water";
+    return createBattleByCategory(10,2,categories,compare_fighters,copy_fighter,free_fighter,
+                                  fighter_category,fighter_attack,print_fighter);
+}
+
+//Replays a journal file into a new battle and returns what its categories print.
+static char* replayed(char* path, int generation, char* out) {
+    Battle b=create_battle();
+    CHECK(replayBattleJournal(b,path,generation,deserialize_fighter,NULL)==success);
+    printed[0]='\0';
+    forEachCategory(b,print_category,NULL);
+    strcpy(out,printed);
+    destroyBattleByCategory(b);
+    return out;
+}
+
+int main(void) {
+    char path[64], expected[sizeof(printed)], actual[sizeof(printed)];
+    snprintf(path,sizeof(path),"/tmp/journal_test_%d.journal",(int)getpid());
+    remove(path);
+    CHECK(getJournalGeneration(path)==-1);
+
+    //Every change is made in the battle and journaled, the insertions once made, the removals first
+    Battle b=create_battle();
+    BattleJournal j=openBattleJournal(path,0,4,serialize_fighter,NULL);
+    CHECK(j!=NULL);
+    if (j==NULL) {return failed_checks;}
+    Fighter fighters[]={{"Fire","Charmander",52},{"Fire","Growlithe",52},{"Water","Squirtle",48},{"Fire","Ekans",52},
+                        {"Fire","Ponyta",65},{"Water","Psyduck",48}};
+    for (int i=0; i<6; i++) {
+        CHECK(insertObject(b,&fighters[i])==success);
+        CHECK(journalInsert(j,&fighters[i])==success);
+        if (i==4) {
+            CHECK(journalRemoveMax(j,getCategoryId(b,"Fire"))==success);
+            free(removeMaxByCategory(b,"Fire"));
+        }
+    }
+    CHECK(syncBattleJournal(j)==success);
+    printed[0]='\0';
+    forEachCategory(b,print_category,NULL);
+    strcpy(expected,printed);
+    CHECK(strcmp(replayed(path,0,actual),expected)==0);
+
+    //Records waiting for their group commit are not in the file yet
+    Fighter late={"Water","Poliwag",48};
+    CHECK(journalInsert(j,&late)==success);
+    CHECK(strcmp(replayed(path,0,actual),expected)==0);
+    CHECK(closeBattleJournal(j)==success);
+    CHECK(strcmp(replayed(path,0,actual),expected)!=0);
+    strcpy(expected,actual);
+
+    //A torn record at the end is cut off
+    FILE* file=fopen(path,"ab");
+    fputs("torn",file);
+    fclose(file);
+    CHECK(strcmp(replayed(path,0,actual),expected)==0);
+    CHECK(strcmp(replayed(path,-1,actual),expected)==0);
+
+    //Only the requested generation is replayed, and a reset journal starts empty with its new generation
+    CHECK(getJournalGeneration(path)==0);
+    CHECK(strcmp(replayed(path,1,actual),"| | ")==0);
+    j=openBattleJournal(path,0,1,serialize_fighter,NULL);
+    CHECK(resetBattleJournal(j,5)==success);
+    CHECK(closeBattleJournal(j)==success);
+    CHECK(getJournalGeneration(path)==5);
+    CHECK(strcmp(replayed(path,5,actual),"| | ")==0);
+
+    remove(path);
+    destroyBattleByCategory(b);
+    return failed_checks;
+}
@@ -0,0 +1,56 @@
+//The cross-category leaderboard and battle iterator: the strongest elements of all categories, equal ones by category id.
+#include "test_common.h"
+#include "BattleByCategory.h"
+
+static Battle create_battle(void) {
+    char categories[]="Fire,Water,Grass";
+    Battle b=createBattleByCategory(UNBOUNDED_CAPACITY,3,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    Fighter fighters[]={{"Grass","Oddish",52},{"Water","Psyduck",48},{"Fire","Ponyta",65},{"Water","Poliwag",52},
+                        {"Fire","Ekans",52},{"Grass","Bulbasaur",49},{"Water","Squirtle",70}};
+    for (int i=0; i<7; i++) {insertObject(b,&fighters[i]);}
+    return b;
+}
+
+//The order of the fighters above, strongest first and equal attacks by category id
+static char* expected_order[]={"Squirtle","Ponyta","Ekans","Poliwag","Oddish","Bulbasaur","Psyduck"};
+
+int main(void) {
+    Battle b=create_battle();
+    element top[10];
+    CHECK(topNOverall(b,10,top)==7);
+    for (int i=0; i<7; i++) {CHECK(strcmp(((Fighter*)top[i])->name,expected_order[i])==0);}
+    CHECK(topNOverall(b,2,top)==2);
+
+    //The battle iterator visits the battle in the same order
+    BattleIterator it=createBattleIterator(b);
+    CHECK(it!=NULL);
+    for (int i=0; i<7; i++) {
+        Fighter* next=(Fighter*)nextInBattleIterator(it);
+        CHECK(next!=NULL && strcmp(next->name,expected_order[i])==0);
+    }
+    CHECK(nextInBattleIterator(it)==NULL);
+    destroyBattleIterator(it);
+    CHECK(getNumberOfObjectsInCategory(b,"Water")==3);
+
+    //Popping keeps the leaderboard up to date, also across the changes of single categories
+    CHECK(strcmp(((Fighter*)topOverall(b))->name,"Squirtle")==0);
+    Fighter* popped=(Fighter*)popOverall(b);
+    CHECK(popped!=NULL && strcmp(popped->name,"Squirtle")==0);
+    free(popped);
+    free(removeMaxByCategory(b,"Fire"));
+    CHECK(strcmp(((Fighter*)topOverall(b))->name,"Ekans")==0);
+    Fighter strong={"Grass","Tangela",90};
+    insertObject(b,&strong);
+    CHECK(strcmp(((Fighter*)topOverall(b))->name,"Tangela")==0);
+    int count=0;
+    while ((popped=(Fighter*)popOverall(b))!=NULL) {
+        free(popped);
+        count++;
+    }
+    CHECK(count==6);
+    CHECK(topOverall(b)==NULL);
+    CHECK(topNOverall(b,3,top)==0);
+    destroyBattleByCategory(b);
+    return failed_checks;
+}
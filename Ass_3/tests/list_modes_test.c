@@ -0,0 +1,148 @@
+//The list modes: the kinds that keep the append order behave like a plain list, an ordered list stays sorted.
+#include "test_common.h"
+#include "LinkedList.h"
+
+//Number of list kinds that create_list knows
+#define LIST_KINDS 5
+
+//Hashes a name string, the search key of the lists below.
+static unsigned long hash_name(element name) {
+    unsigned long hash=5381;
+    for (char* c=(char*)name; *c; c++) {hash=hash*33+(unsigned char)*c;}
+    return hash;
+}
+
+static unsigned long hash_fighter_name(element elem) {
+    return hash_name(((Fighter*)elem)->name);
+}
+
+//Creates a list of the given kind, all of them keep the append order and find fighters by name.
+//Kinds 2 and 3 are kinds 0 and 1 allocating their nodes from a pool of small slabs, kind 4 is an unrolled list
+//with small blocks, so that deletions empty whole blocks.
+static LinkedList create_list(int kind) {
+    LinkedList list=NULL;
+    switch (kind<4 ? kind%2 : kind) {
+        case 0:
+            list=createLinkedList(copy_fighter,free_fighter,print_fighter,fighter_named,compare_fighters);
+            break;
+        case 1:
+            list=createIndexedLinkedList(copy_fighter,free_fighter,print_fighter,fighter_named,compare_fighters,
+                                         hash_name,hash_fighter_name);
+            break;
+        case 4:
+            list=createUnrolledLinkedList(copy_fighter,free_fighter,print_fighter,fighter_named,compare_fighters,4);
+            break;
+    }
+    if (list && (kind==2 || kind==3) && setNodePool(list,16)!=success) {
+        destroyLinkedList(list);
+        return NULL;
+    }
+    return list;
+}
+
+//Collects the names of the visited fighters into printed, stopping after the name given as context.
+static bool collect_until(element elem, element last) {
+    print_fighter(elem);
+    return strcmp(((Fighter*)elem)->name,(char*)last)!=0;
+}
+
+//Appends, searches and deletes on a list, then checks what it prints and visits.
+static void run_list(LinkedList list) {
+    char name[16];
+    char expected[1024]="";
+    for (int i=0; i<100; i++) {
+        Fighter fighter={"Fire","",i};
+        snprintf(fighter.name,sizeof(fighter.name),"f%d",i);
+        CHECK(appendNode(list,&fighter)==success);
+    }
+    for (int i=0; i<100; i+=3) {
+        snprintf(name,sizeof(name),"f%d",i);
+        CHECK(deleteNode(list,name)==success);
+    }
+    for (int i=40; i<50; i++) {
+        if (i%3==0) {continue;}
+        snprintf(name,sizeof(name),"f%d",i);
+        CHECK(deleteNode(list,name)==success);
+    }
+    CHECK(deleteNode(list,"f0")==failure);
+    for (int i=0; i<100; i++) {
+        snprintf(name,sizeof(name),"f%d",i);
+        Fighter* found=(Fighter*)searchByKeyInList(list,name);
+        bool deleted=i%3==0 || (i>=40 && i<50);
+        CHECK(deleted ? found==NULL : found!=NULL && found->attack==i);
+        if (!deleted) {
+            strcat(expected,name);
+            strcat(expected," ");
+        }
+    }
+    //A name that was deleted can come back, at the end of the list
+    Fighter again={"Fire","f0",1000};
+    CHECK(appendNode(list,&again)==success);
+    CHECK(((Fighter*)searchByKeyInList(list,"f0"))->attack==1000);
+    strcat(expected,"f0 ");
+    printed[0]='\0';
+    CHECK(printLinkedList(list)==success);
+    CHECK(strcmp(printed,expected)==0);
+    printed[0]='\0';
+    CHECK(forEachInList(list,collect_until,"no such name")==success);
+    CHECK(strcmp(printed,expected)==0);
+    printed[0]='\0';
+    CHECK(forEachInList(list,collect_until,"f2")==success);
+    CHECK(strcmp(printed,"f1 f2 ")==0);
+    //The pool can only be set while the list is empty
+    CHECK(setNodePool(list,16)==failure);
+}
+
+//Collects the attacks of the visited fighters into printed, stopping after the attack given as context.
+static bool collect_attacks_until(element elem, element last) {
+    char attack[16];
+    snprintf(attack,sizeof(attack),"%d ",((Fighter*)elem)->attack);
+    strcat(printed,attack);
+    return ((Fighter*)elem)->attack<*(int*)last;
+}
+
+//An ordered list keeps its fighters sorted by attack, equal attacks in append order, and scans from a key.
+static void test_ordered_list(void) {
+    LinkedList list=createOrderedLinkedList(copy_fighter,free_fighter,print_fighter,compare_fighters,compare_fighters);
+    CHECK(list!=NULL);
+    int attacks[]={52,48,65,52,49,48,52};
+    char* names[]={"Charmander","Squirtle","Ponyta","Growlithe","Bulbasaur","Psyduck","Ekans"};
+    for (int i=0; i<7; i++) {
+        Fighter fighter={"Fire","",attacks[i]};
+        strcpy(fighter.name,names[i]);
+        CHECK(appendNode(list,&fighter)==success);
+    }
+    printed[0]='\0';
+    CHECK(printLinkedList(list)==success);
+    CHECK(strcmp(printed,"Squirtle Psyduck Bulbasaur Charmander Growlithe Ekans Ponyta ")==0);
+
+    Fighter probe={"Fire","",49};
+    Fighter* found=(Fighter*)searchByKeyInList(list,&probe);
+    CHECK(found!=NULL && strcmp(found->name,"Bulbasaur")==0);
+    CHECK(deleteNode(list,&probe)==success);
+    CHECK(searchByKeyInList(list,&probe)==NULL);
+
+    //The scan starts at the first attack not below 50 and stops after the first 52
+    Fighter from={"Fire","",50};
+    int last=52;
+    printed[0]='\0';
+    CHECK(forEachFromKey(list,&from,collect_attacks_until,&last)==success);
+    CHECK(strcmp(printed,"52 ")==0);
+    last=100;
+    printed[0]='\0';
+    CHECK(forEachFromKey(list,&from,collect_attacks_until,&last)==success);
+    CHECK(strcmp(printed,"52 52 52 65 ")==0);
+    destroyLinkedList(list);
+}
+
+int main(void) {
+    for (int kind=0; kind<LIST_KINDS; kind++) {
+        LinkedList list=create_list(kind);
+        CHECK(list!=NULL);
+        if (list==NULL) {continue;}
+        run_list(list);
+        CHECK(destroyLinkedList(list)==success);
+    }
+    test_ordered_list();
+    return failed_checks;
+}
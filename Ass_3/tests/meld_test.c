@@ -0,0 +1,68 @@
+//Melding heaps and merging battles move elements without copying them.
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+static void test_meld_heaps(void) {
+    MaxHeap dst=createIndexedHeap("dst",UNBOUNDED_CAPACITY,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    MaxHeap src=createHeapWithArity("src",UNBOUNDED_CAPACITY,4,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    int handle;
+    Fighter kept={"Fire","Kept",33};
+    CHECK(insertWithHandle(dst,&kept,&handle)==success);
+    for (int i=0; i<40; i++) {
+        Fighter fighter={"Fire","",(i*11)%50};
+        insertToHeap(i%2 ? dst : src,&fighter);
+    }
+    Fighter* moved=(Fighter*)TopMaxHeap(src);
+    CHECK(meldHeaps(dst,src)==success);
+    CHECK(getHeapCurrentSize(src)==0);
+    CHECK(getHeapCurrentSize(dst)==41);
+    CHECK(strcmp(((Fighter*)getByHandle(dst,handle))->name,"Kept")==0);
+    CHECK(meldHeaps(dst,dst)==failure);
+
+    int last=1000;
+    bool found=false;
+    Fighter* top;
+    while ((top=(Fighter*)PopMaxHeap(dst))!=NULL) {
+        CHECK(top->attack<=last);
+        last=top->attack;
+        if (top==moved) {found=true;}
+        free(top);
+    }
+    CHECK(found);
+    destroyHeap(dst);
+    destroyHeap(src);
+}
+
+static void test_merge_battles(void) {
+    char dst_categories[]="Fire,Water,Grass";
+    char src_categories[]="Water,Fire";
+    Battle dst=createBattleByCategory(5,3,dst_categories,compare_fighters,copy_fighter,free_fighter,
+                                      fighter_category,fighter_attack,print_fighter);
+    Battle src=createBattleByCategory(5,2,src_categories,compare_fighters,copy_fighter,free_fighter,
+                                      fighter_category,fighter_attack,print_fighter);
+    Fighter fighters[]={{"Fire","Ponyta",65},{"Water","Psyduck",48},{"Water","Poliwag",48},{"Fire","Ekans",52}};
+    for (int i=0; i<4; i++) {insertObject(src,&fighters[i]);}
+    insertObject(dst,&fighters[0]);
+
+    CHECK(mergeCategories(dst,src,"Water")==success);
+    CHECK(getNumberOfObjectsInCategory(dst,"Water")==2);
+    CHECK(getNumberOfObjectsInCategory(src,"Water")==0);
+    CHECK(mergeCategories(dst,src,"Grass")!=success);
+    CHECK(mergeBattle(dst,src)==success);
+    CHECK(getNumberOfObjectsInCategory(dst,"Fire")==3);
+    CHECK(getNumberOfObjectsInCategory(src,"Fire")==0);
+
+    //A merge that would overflow a category of dst is refused as a whole
+    for (int i=0; i<5; i++) {insertObject(src,&fighters[1]);}
+    CHECK(mergeBattle(dst,src)==failure_fullcapacity);
+    CHECK(getNumberOfObjectsInCategory(src,"Water")==5);
+    destroyBattleByCategory(dst);
+    destroyBattleByCategory(src);
+}
+
+int main(void) {
+    test_meld_heaps();
+    test_merge_battles();
+    return failed_checks;
+}
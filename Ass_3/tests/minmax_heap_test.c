@@ -0,0 +1,78 @@
+//Min-max heaps reach both ends, and the evict_weakest policy replaces the weakest element of a full category.
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+//Removes elements from both ends in turns, checking that each end is the current maximum or minimum.
+static void drain_both_ends(MaxHeap heap) {
+    int high=1000, low=-1, turn=0;
+    while (getHeapCurrentSize(heap)>0) {
+        Fighter* top=(Fighter*)TopMaxHeap(heap);
+        Fighter* bottom=(Fighter*)TopMinHeap(heap);
+        CHECK(top->attack>=bottom->attack);
+        Fighter* removed=(Fighter*)(turn%2 ? PopMinHeap(heap) : PopMaxHeap(heap));
+        CHECK(turn%2 ? removed->attack>=low : removed->attack<=high);
+        if (turn%2) {low=removed->attack;} else {high=removed->attack;}
+        free(removed);
+        turn++;
+    }
+}
+
+static void test_min_max(void) {
+    MaxHeap heap=createMinMaxHeap("minmax",UNBOUNDED_CAPACITY,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    for (int i=0; i<101; i++) {
+        Fighter fighter={"Fire","",(i*43)%97};
+        CHECK(insertToHeap(heap,&fighter)==success);
+    }
+    CHECK(((Fighter*)TopMinHeap(heap))->attack==0);
+    CHECK(((Fighter*)TopMaxHeap(heap))->attack==96);
+    drain_both_ends(heap);
+    CHECK(TopMinHeap(heap)==NULL && PopMinHeap(heap)==NULL);
+    destroyHeap(heap);
+
+    //A plain heap turned into a min-max heap keeps its elements
+    heap=createHeap("plain",UNBOUNDED_CAPACITY,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    for (int i=0; i<64; i++) {
+        Fighter fighter={"Fire","",(i*7)%31};
+        insertToHeap(heap,&fighter);
+    }
+    CHECK(TopMinHeap(heap)==NULL);
+    CHECK(convertToMinMaxHeap(heap)==success);
+    CHECK(getHeapCurrentSize(heap)==64);
+    drain_both_ends(heap);
+    destroyHeap(heap);
+}
+
+//Under evict_weakest a stronger newcomer replaces the weakest element, a weaker one is still refused.
+static void test_evict_weakest(void) {
+    char categories[]="Fire,Water";
+    Battle b=createBattleByCategory(3,2,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    CHECK(setCapacityPolicy(b,evict_weakest)==success);
+    Fighter fighters[]={{"Fire","Charmander",52},{"Fire","Growlithe",52},{"Fire","Ponyta",65}};
+    for (int i=0; i<3; i++) {CHECK(insertObject(b,&fighters[i])==success);}
+    Fighter weaker={"Fire","Slugma",40};
+    CHECK(insertObject(b,&weaker)==failure_fullcapacity);
+    Fighter stronger={"Fire","Magmar",95};
+    CHECK(insertObject(b,&stronger)==success);
+    CHECK(getNumberOfObjectsInCategory(b,"Fire")==3);
+
+    //A batch that only makes room by eviction is fully inserted, one with weaker elements is not
+    element batch[2]={new_fighter("Fire","Arcanine",90),new_fighter("Fire","Rapidash",80)};
+    CHECK(insertObjectsBulk(b,batch,2)==success);
+    batch[0]=new_fighter("Fire","Vulpix",30);
+    CHECK(insertObjectsBulk(b,batch,1)==failure_fullcapacity);
+    int expected[]={95,90,80};
+    for (int i=0; i<3; i++) {
+        Fighter* strongest=(Fighter*)removeMaxByCategory(b,"Fire");
+        CHECK(strongest!=NULL && strongest->attack==expected[i]);
+        free(strongest);
+    }
+    destroyBattleByCategory(b);
+}
+
+int main(void) {
+    test_min_max();
+    test_evict_weakest();
+    return failed_checks;
+}
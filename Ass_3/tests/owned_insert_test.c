@@ -0,0 +1,52 @@
+//Inserts that hand an element over instead of copying it: insertToHeapOwned, appendNodeOwned and insertObjectOwned.
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "LinkedList.h"
+#include "BattleByCategory.h"
+
+//The heap keeps the given element itself, and a refused element stays the caller's.
+static void test_heap_owned(void) {
+    MaxHeap heap=createHeap("owned",1,copy_fighter,free_fighter,print_fighter,compare_fighters);
+    Fighter* fighter=new_fighter("Fire","Ponyta",65);
+    CHECK(insertToHeapOwned(heap,fighter)==success);
+    CHECK(TopMaxHeap(heap)==fighter);
+    Fighter* refused=new_fighter("Fire","Ekans",52);
+    CHECK(insertToHeapOwned(heap,refused)==failure_fullcapacity);
+    free(refused);
+    CHECK(PopMaxHeap(heap)==fighter);
+    free(fighter);
+    destroyHeap(heap);
+}
+
+static void test_list_owned(void) {
+    LinkedList list=createLinkedList(copy_fighter,free_fighter,print_fighter,compare_fighters,compare_fighters);
+    Fighter* fighter=new_fighter("Water","Psyduck",48);
+    CHECK(appendNodeOwned(list,fighter)==success);
+    CHECK(searchByKeyInList(list,fighter)==fighter);
+    CHECK(appendNodeOwned(list,NULL)==failure);
+    destroyLinkedList(list);
+}
+
+static void test_battle_owned(void) {
+    char categories[]="Fire,Water";
+    Battle b=createBattleByCategory(1,2,categories,compare_fighters,copy_fighter,free_fighter,
+                                    fighter_category,fighter_attack,print_fighter);
+    Fighter* fighter=new_fighter("Water","Poliwag",48);
+    CHECK(insertObjectOwned(b,fighter)==success);
+    Fighter* refused=new_fighter("Water","Squirtle",48);
+    CHECK(insertObjectOwned(b,refused)!=success);
+    free(refused);
+    Fighter* unknown=new_fighter("Grass","Oddish",49);
+    CHECK(insertObjectOwned(b,unknown)!=success);
+    free(unknown);
+    CHECK(removeMaxByCategory(b,"Water")==fighter);
+    free(fighter);
+    destroyBattleByCategory(b);
+}
+
+int main(void) {
+    test_heap_owned();
+    test_list_owned();
+    test_battle_owned();
+    return failed_checks;
+}
@@ -0,0 +1,34 @@
+#!/bin/bash
+# Builds and runs every test of this directory: the C drivers (*_test.c), linked with the battle
+# modules, and the shell tests (*_test.sh), which get the build directory as their argument.
+# The drivers report failed checks on stderr, what they print through the ADTs is discarded.
+# Run from anywhere: bash tests/run_tests.sh (or make test). The exit status is 0 if all tests passed.
+cd "$(dirname "$0")/.." || exit 1
+build=$(mktemp -d)
+trap 'rm -rf "$build"' EXIT
+failed=0
+
+for src in tests/*_test.c; do
+    name=$(basename "$src" .c)
+    if ! gcc -I. -o "$build/$name" "$src" MaxHeap.c LinkedList.c BattleByCategory.c -pthread; then
+        echo "FAIL $name (build)"
+        failed=1
+    elif ! timeout 120 "$build/$name" >/dev/null; then
+        echo "FAIL $name"
+        failed=1
+    else
+        echo "ok   $name"
+    fi
+done
+
+for script in tests/*_test.sh; do
+    name=$(basename "$script" .sh)
+    if ! bash "$script" "$build"; then
+        echo "FAIL $name"
+        failed=1
+    else
+        echo "ok   $name"
+    fi
+done
+
+exit $failed
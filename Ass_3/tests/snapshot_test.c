@@ -0,0 +1,80 @@
+//Binary snapshots: a battle saved and loaded again has the same categories, order and equal-key order.
+#include <unistd.h>
+#include "test_common.h"
+#include "MaxHeap.h"
+#include "BattleByCategory.h"
+
+static int serialize_fighter(element elem, char* buffer, int size, element ctx) {
+    (void)ctx;
+    if (size>=(int)sizeof(Fighter)) {memcpy(buffer,elem,sizeof(Fighter));}
+    return sizeof(Fighter);
+}
+
+static element deserialize_fighter(char* buffer, int size, element ctx) {
+    (void)ctx;
+    if (size!=(int)sizeof(Fighter)) {return NULL;}
+    return copy_fighter(buffer);
+}
+
+//Prints every category of a battle into printed, each in the order printHeap gives.
+static bool print_category(element heap, element ctx) {
+    (void)ctx;
+    printHeap((MaxHeap)heap);
+    strcat(printed,"| ");
+    return true;
+}
+
+static Battle create_battle(char* categories) {
+    return createBattleByCategory(10,3,categories,compare_fighters,copy_fighter,free_fighter,
+                                  fighter_category,fighter_attack,print_fighter);
+}
+
+int main(void) {
+    char path[64];
+    snprintf(path,sizeof(path),"/tmp/snapshot_test_%d.snap",(int)getpid());
+    char categories[]="Fire,Water,Grass";
+    Battle b=create_battle(categories);
+    Fighter fighters[]={{"Fire","Charmander",52},{"Fire","Growlithe",52},{"Fire","Ekans",52},{"Fire","Ponyta",65},
+                        {"Water","Squirtle",48},{"Water","Psyduck",48},{"Grass","Oddish",49}};
+    for (int i=0; i<7; i++) {insertObject(b,&fighters[i]);}
+    free(removeMaxByCategory(b,"Fire"));
+    char meta[]="meta bytes";
+    CHECK(saveBattleSnapshot(b,path,meta,sizeof(meta),serialize_fighter,NULL)==success);
+
+    BattleSnapshot snap=openBattleSnapshot(path);
+    CHECK(snap!=NULL);
+    if (snap==NULL) {return failed_checks;}
+    CHECK(strcmp(getSnapshotCategories(snap),categories)==0);
+    int meta_size=0;
+    CHECK(memcmp(getSnapshotMeta(snap,&meta_size),meta,sizeof(meta))==0 && meta_size==(int)sizeof(meta));
+
+    Battle loaded=create_battle(getSnapshotCategories(snap));
+    CHECK(loadBattleSnapshot(loaded,snap,deserialize_fighter,NULL)==success);
+    char other_categories[]="Fire,Water,Ice";
+    Battle other=create_battle(other_categories);
+    CHECK(loadBattleSnapshot(other,snap,deserialize_fighter,NULL)==failure);
+    destroyBattleByCategory(other);
+    closeBattleSnapshot(snap);
+
+    printed[0]='\0';
+    forEachCategory(b,print_category,NULL);
+    char original[sizeof(printed)];
+    strcpy(original,printed);
+    printed[0]='\0';
+    forEachCategory(loaded,print_category,NULL);
+    CHECK(strcmp(printed,original)==0);
+    CHECK(strcmp(original,"Growlithe Ekans Charmander | Squirtle Psyduck | Oddish | ")==0);
+
+    //A cut file is not a snapshot
+    FILE* file=fopen(path,"r+");
+    fseek(file,0,SEEK_END);
+    CHECK(ftruncate(fileno(file),ftell(file)-1)==0);
+    fclose(file);
+    CHECK(openBattleSnapshot(path)==NULL);
+    remove(path);
+    CHECK(openBattleSnapshot(path)==NULL);
+
+    destroyBattleByCategory(b);
+    destroyBattleByCategory(loaded);
+    return failed_checks;
+}
@@ -0,0 +1,96 @@
+#ifndef ASS_3_TEST_COMMON_H
+#define ASS_3_TEST_COMMON_H
+
+//Shared helpers of the test drivers: a check macro, and a small generic element (a fighter with a category,
+//a name and an attack) together with the functions that the generic ADTs expect.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Defs.h"
+
+//Number of failed checks, a driver returns it from main so that any failure fails the test.
+static int failed_checks=0;
+
+//Reports a failed condition with its line and lets the driver go on with the next checks.
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr,"%s:%d: check failed: %s\n",__FILE__,__LINE__,#cond); \
+        failed_checks++; \
+    } \
+} while (0)
+
+typedef struct Fighter_s {
+    char category[16];
+    char name[16];
+    int attack;
+} Fighter;
+
+//The names printed by print_fighter, separated by spaces, so a driver can check what a print function printed.
+static char printed[4096];
+
+static Fighter* new_fighter(char* category, char* name, int attack) {
+    Fighter* fighter=(Fighter*)malloc(sizeof(Fighter));
+    if (fighter==NULL) {return NULL;}
+    strncpy(fighter->category,category,sizeof(fighter->category)-1);
+    fighter->category[sizeof(fighter->category)-1]='\0';
+    strncpy(fighter->name,name,sizeof(fighter->name)-1);
+    fighter->name[sizeof(fighter->name)-1]='\0';
+    fighter->attack=attack;
+    return fighter;
+}
+
+static element copy_fighter(element elem) {
+    if (elem==NULL) {return NULL;}
+    Fighter* copy=(Fighter*)malloc(sizeof(Fighter));
+    if (copy==NULL) {return NULL;}
+    *copy=*(Fighter*)elem;
+    return copy;
+}
+
+static status free_fighter(element elem) {
+    free(elem);
+    return success;
+}
+
+static status print_fighter(element elem) {
+    if (elem==NULL) {return failure;}
+    //A full log keeps its beginning, the names that do not fit are dropped
+    if (strlen(printed)+strlen(((Fighter*)elem)->name)+2>sizeof(printed)) {return success;}
+    strcat(printed,((Fighter*)elem)->name);
+    strcat(printed," ");
+    return success;
+}
+
+//Orders fighters by attack, as the equalFunction of Defs.h.
+static int compare_fighters(element elem1, element elem2) {
+    int attack1=((Fighter*)elem1)->attack, attack2=((Fighter*)elem2)->attack;
+    if (attack1>attack2) {return 1;}
+    if (attack1<attack2) {return -1;}
+    return 0;
+}
+
+static char* fighter_category(element elem) {
+    return ((Fighter*)elem)->category;
+}
+
+//The attack of a fight: a fighter of category "Water" beats "Fire" by 10 points, otherwise the plain attacks.
+static int fighter_attack(element elem1, element elem2, int* attack1, int* attack2) {
+    Fighter* fighter1=(Fighter*)elem1;
+    Fighter* fighter2=(Fighter*)elem2;
+    *attack1=fighter1->attack;
+    *attack2=fighter2->attack;
+    if (strcmp(fighter1->category,"Fire")==0 && strcmp(fighter2->category,"Water")==0) {*attack1-=10;}
+    if (strcmp(fighter1->category,"Water")==0 && strcmp(fighter2->category,"Fire")==0) {*attack2-=10;}
+    return *attack1-*attack2;
+}
+
+static int fighter_key(element elem) {
+    return ((Fighter*)elem)->attack;
+}
+
+//Matches a fighter by name (the key is the name string), returning 0 for a match.
+static int fighter_named(element elem, element name) {
+    return strcmp(((Fighter*)elem)->name,(char*)name)==0 ? 0 : 1;
+}
+
+#endif //ASS_3_TEST_COMMON_H